@@ -25,7 +25,10 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
-#include <math.h>
+#include <PagedSSD1306.h>
+#include <LedAnimation.h>
+#include <ButtonEvents.h>
+#include <ToneSequencer.h>
 
 // ----------------------- Pin Mapping -----------------------
 #define PIN_BUZZER      27
@@ -49,7 +52,7 @@
 #define OLED_WIDTH  128
 #define OLED_HEIGHT 64
 #define OLED_ADDR   0x3C
-Adafruit_SSD1306 oled(OLED_WIDTH, OLED_HEIGHT, &Wire, -1);
+PagedSSD1306 oled(OLED_WIDTH, OLED_HEIGHT, &Wire, -1);
 
 // ----------------------- Mode Management -------------------
 enum LightingMode {
@@ -62,18 +65,41 @@ enum LightingMode {
 
 LightingMode currentMode = MODE_OFF;
 
-// ----------------------- Timing Variables ------------------
-unsigned long blinkTimer = 0;
-const unsigned long BLINK_DELAY = 400;
-bool blinkState = false;
+// ----------------------- Patterns --------------------------
+// One row per mode, channels in LED_CHANNELS order (red, green, yellow).
+// A new effect is a new row here (and a name in LightingMode), no code.
+//   shape, period ms, phase offset (1/256 turn), square duty, lo, hi
+const LedPattern PATTERNS[TOTAL_MODES] = {
+  { "All OFF", false, {
+    { WAVE_OFF, 0, 0, 0, 0, 0 },
+    { WAVE_OFF, 0, 0, 0, 0, 0 },
+    { WAVE_OFF, 0, 0, 0, 0, 0 } } },
+  // One LED at a time, 400 ms on / 400 ms off, red -> green -> yellow
+  { "Alternate", false, {
+    { WAVE_SQUARE, 2400, 0,   43, 0, 255 },
+    { WAVE_SQUARE, 2400, 171, 43, 0, 255 },
+    { WAVE_SQUARE, 2400, 85,  43, 0, 255 } } },
+  { "All ON", false, {
+    { WAVE_ON, 0, 0, 0, 0, 255 },
+    { WAVE_ON, 0, 0, 0, 0, 255 },
+    { WAVE_ON, 0, 0, 0, 0, 255 } } },
+  // 2 s sine, channels a third of a turn apart, gamma corrected
+  { "PWM Fade", true, {
+    { WAVE_SINE, 2000, 0,   0, 0, 255 },
+    { WAVE_SINE, 2000, 85,  0, 0, 255 },
+    { WAVE_SINE, 2000, 171, 0, 0, 255 } } },
+};
+
+const uint8_t LED_CHANNELS[LED_ANIM_CHANNELS] = { RED_CHANNEL, GREEN_CHANNEL, YELLOW_CHANNEL };
+Animator animator;
 
-unsigned long fadeTimer = 0;
-unsigned long btnPressStart = 0;
-bool btnPressed = false;
-bool longPressHandled = false;
+// ----------------------- Buttons ---------------------------
+// Debounced in the background; loop() only reads events
+ButtonEvents buttons;
+int8_t modeButton, actionButton, bootButton;
 
-unsigned long lastModePress = 0, lastBootPress = 0;
-const unsigned long DEBOUNCE_DELAY = 50;
+// ----------------------- Buzzer ----------------------------
+ToneSequencer buzzer(BUZZER_CHANNEL);   // tones end on a timer, not in loop()
 
 // Manual LED toggle state (used after short press)
 bool manualOverride = false;
@@ -102,41 +128,15 @@ void changeMode(LightingMode mode) {
   currentMode = mode;
   manualOverride = false;  // disable manual LED state if new mode selected
 
-  switch (mode) {
-    case MODE_OFF:
-      showOLED("Mode:", "All OFF");
-      ledcWrite(RED_CHANNEL, 0);
-      ledcWrite(GREEN_CHANNEL, 0);
-      ledcWrite(YELLOW_CHANNEL, 0);
-      break;
-
-    case MODE_ALTERNATE:
-      showOLED("Mode:", "Alternate");
-      blinkTimer = millis();
-      blinkState = false;
-      break;
-
-    case MODE_ALL_ON:
-      showOLED("Mode:", "All ON");
-      ledcWrite(RED_CHANNEL, 255);
-      ledcWrite(GREEN_CHANNEL, 255);
-      ledcWrite(YELLOW_CHANNEL, 255);
-      break;
-
-    case MODE_FADE:
-      showOLED("Mode:", "PWM Fade");
-      fadeTimer = millis();
-      break;
-  }
+  showOLED("Mode:", PATTERNS[mode].name);
+  animator.start(PATTERNS[mode], millis());
 }
 
 // ============================================================================
-// Buzzer Utility — Simple tone function
+// Buzzer Utility — Simple tone function (returns at once)
 // ============================================================================
 void playTone(unsigned int frequency, unsigned long duration) {
-  ledcWriteTone(BUZZER_CHANNEL, frequency);
-  delay(duration);
-  ledcWriteTone(BUZZER_CHANNEL, 0);
+  buzzer.tone(frequency, duration, true);  // replaces a tone still sounding
 }
 
 // ============================================================================
@@ -145,14 +145,16 @@ void playTone(unsigned int frequency, unsigned long duration) {
 void setup() {
   Serial.begin(115200);
 
-  // Configure input pins with internal pull-ups
-  pinMode(PIN_MODE_BTN, INPUT_PULLUP);
-  pinMode(PIN_ACTION_BTN, INPUT_PULLUP);
-  pinMode(PIN_BOOT_BTN, INPUT_PULLUP);
+  // Buttons to GND with internal pull-ups, interrupt driven
+  modeButton = buttons.add(PIN_MODE_BTN);
+  actionButton = buttons.add(PIN_ACTION_BTN);   // short: toggle, long (1.5 s): buzzer
+  bootButton = buttons.add(PIN_BOOT_BTN);
+  buttons.begin();
 
   // Configure LED pins for PWM output
   ledcSetup(BUZZER_CHANNEL, 2000, PWM_RESOLUTION);
   ledcAttachPin(PIN_BUZZER, BUZZER_CHANNEL);
+  buzzer.begin();
 
   ledcSetup(RED_CHANNEL, LED_PWM_FREQ, PWM_RESOLUTION);
   ledcAttachPin(PIN_LED_RED, RED_CHANNEL);
@@ -179,52 +181,23 @@ void setup() {
 void loop() {
   unsigned long now = millis();
 
-  // -------------------- MODE BUTTON --------------------
-  if (digitalRead(PIN_MODE_BTN) == LOW) {
-    if (now - lastModePress > DEBOUNCE_DELAY) {
-      currentMode = (LightingMode)((currentMode + 1) % TOTAL_MODES);
-      changeMode(currentMode);
-      while (digitalRead(PIN_MODE_BTN) == LOW) delay(10);
-      lastModePress = millis();
-    }
-  }
+  // -------------------- BUTTON EVENTS --------------------
+  // Already debounced; reading never waits for a button to be released
+  ButtonEvent e;
+  while (buttons.read(e)) {
+    if (e.button == modeButton && e.type == BTN_PRESS) {
+      changeMode((LightingMode)((currentMode + 1) % TOTAL_MODES));
 
-  // -------------------- BOOT BUTTON --------------------
-  if (digitalRead(PIN_BOOT_BTN) == LOW) {
-    if (now - lastBootPress > DEBOUNCE_DELAY) {
+    } else if (e.button == bootButton && e.type == BTN_PRESS) {
       changeMode(MODE_OFF);
       showOLED("System:", "Reset (BOOT)");
-      while (digitalRead(PIN_BOOT_BTN) == LOW) delay(10);
-      lastBootPress = millis();
-    }
-  }
-
-  // -------------------- ACTION BUTTON --------------------
-  int actionState = digitalRead(PIN_ACTION_BTN);
 
-  // Detect initial press
-  if (actionState == LOW && !btnPressed) {
-    btnPressed = true;
-    btnPressStart = now;
-    longPressHandled = false;
-  }
-
-  // Handle long press (buzzer)
-  if (actionState == LOW && btnPressed && !longPressHandled) {
-    if (now - btnPressStart >= 1500) { // 1.5 sec = long press
+    } else if (e.button == actionButton && e.type == BTN_LONG) {
       showOLED("Action:", "Long Press");
       playTone(2500, 300);
-      longPressHandled = true;
-    }
-  }
 
-  // Handle release
-  if (actionState == HIGH && btnPressed) {
-    unsigned long pressDuration = now - btnPressStart;
-    btnPressed = false;
-
-    // If short press, toggle LEDs manually
-    if (!longPressHandled && pressDuration < 1500) {
+    } else if (e.button == actionButton && e.type == BTN_SHORT) {
+      // Short press toggles all LEDs manually
       manualOverride = true;
       manualLedState = !manualLedState;
 
@@ -243,42 +216,12 @@ void loop() {
   }
 
   // -------------------- LED MODE BEHAVIOR --------------------
+  // Only channels whose level changed are written to LEDC
   if (!manualOverride) {
-    switch (currentMode) {
-
-      case MODE_ALTERNATE:
-        if (now - blinkTimer >= BLINK_DELAY) {
-          blinkTimer = now;
-          blinkState = !blinkState;
-          static int ledIndex = 0;
-          if (blinkState) {
-            ledIndex = (ledIndex + 1) % 3;
-            ledcWrite(RED_CHANNEL, (ledIndex == 0) ? 255 : 0);
-            ledcWrite(GREEN_CHANNEL, (ledIndex == 1) ? 255 : 0);
-            ledcWrite(YELLOW_CHANNEL, (ledIndex == 2) ? 255 : 0);
-          } else {
-            ledcWrite(RED_CHANNEL, 0);
-            ledcWrite(GREEN_CHANNEL, 0);
-            ledcWrite(YELLOW_CHANNEL, 0);
-          }
-        }
-        break;
-
-      case MODE_FADE: {
-        unsigned long elapsed = (now - fadeTimer) % 2000;
-        float t = elapsed / 2000.0f;
-        float r = (sin(2 * PI * t) + 1.0f) / 2.0f;
-        float g = (sin(2 * PI * (t + 1.0 / 3.0)) + 1.0f) / 2.0f;
-        float y = (sin(2 * PI * (t + 2.0 / 3.0)) + 1.0f) / 2.0f;
-
-        ledcWrite(RED_CHANNEL,   (int)(r * 255));
-        ledcWrite(GREEN_CHANNEL, (int)(g * 255));
-        ledcWrite(YELLOW_CHANNEL,(int)(y * 255));
-        break;
-      }
-
-      default:
-        break;
+    uint8_t levels[LED_ANIM_CHANNELS];
+    uint8_t changed = animator.update(now, levels);
+    for (uint8_t i = 0; i < LED_ANIM_CHANNELS; i++) {
+      if (changed & (1 << i)) ledcWrite(LED_CHANNELS[i], levels[i]);
     }
   }
 
@@ -0,0 +1,8 @@
+// Boot-time micro-benchmarks, built only in the `bench` environment
+// (-DAQUARIUM_BENCH). Results are printed to Serial before networking starts.
+
+#pragma once
+
+#ifdef AQUARIUM_BENCH
+void runBenchmarks();
+#endif
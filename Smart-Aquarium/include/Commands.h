@@ -0,0 +1,27 @@
+// Messages exchanged between the network task (core 0) and the control
+// task (core 1) through SpscRing queues.
+
+#pragma once
+
+#include <Arduino.h>
+#include "TopicDispatch.h"
+#include "StatePublisher.h"
+
+#define COMMAND_TEXT_LEN  STATE_VALUE_LEN
+#define BLYNK_PIN_NONE    -1
+
+// Network -> control: what to do
+struct Command {
+    AquariumCommand type;
+    bool on;                        // CMD_PUMP / CMD_HEATER / CMD_LED
+    bool fromBlynk;                 // do not echo the switch back to Blynk
+    char text[COMMAND_TEXT_LEN];    // CMD_SCHEDULE_*: "HH:MM-HH:MM[@mask],..."
+};
+
+// Control -> network: what changed
+struct StateEvent {
+    StateField field;
+    int8_t blynkPin;                // virtual pin to mirror, or BLYNK_PIN_NONE
+    int8_t blynkValue;
+    char value[STATE_VALUE_LEN];
+};
@@ -0,0 +1,62 @@
+// Non-blocking servo motion engine
+// Steps servo trajectories from loop() (or a timer callback) without ever
+// calling delay(). Each slot runs one motion; starting a new motion in a
+// busy slot replaces the old one from its current position. LED fades run
+// on the LEDC fade hardware instead (LedcFader).
+
+#pragma once
+
+#include <Arduino.h>
+#include <ESP32Servo.h>
+
+#define MOTION_MAX_SLOTS      4
+#define MOTION_MAX_WAYPOINTS  4
+#define MOTION_REPORT_PERCENT 25   // progress callback granularity
+
+// Called on progress (every MOTION_REPORT_PERCENT) and once more on completion
+typedef void (*MotionCallback)(uint8_t slot, uint8_t percent, bool done);
+
+enum MotionKind : uint8_t {
+    MOTION_IDLE = 0,
+    MOTION_SERVO    // servo angle trajectory
+};
+
+struct Motion {
+    MotionKind kind;
+    Servo* servo;                            // target servo
+    int16_t waypoints[MOTION_MAX_WAYPOINTS]; // [0] = start position
+    uint8_t numWaypoints;
+    uint8_t target;                          // waypoint currently heading to
+    int16_t position;
+    uint8_t stepSize;
+    uint16_t stepMs;
+    uint32_t lastStep;
+    uint16_t stepsDone;
+    uint16_t stepsTotal;
+    uint8_t lastReported;
+    MotionCallback cb;
+};
+
+class MotionEngine {
+public:
+    MotionEngine();
+
+    // Move a servo through waypoints[0..n-1]; the servo must already be attached
+    bool startServo(uint8_t slot, Servo& servo, const int16_t* waypoints, uint8_t n,
+                    uint8_t step, uint16_t stepMs, MotionCallback cb = nullptr);
+
+    void cancel(uint8_t slot);
+    bool active(uint8_t slot) const;
+    int16_t position(uint8_t slot) const;
+
+    // Advances every running motion by the number of steps elapsed since its
+    // last update and writes the new position once. Cheap when idle.
+    void update(uint32_t nowMs);
+
+private:
+    bool begin(uint8_t slot, const int16_t* waypoints, uint8_t n,
+               uint8_t step, uint16_t stepMs, MotionCallback cb);
+    void apply(Motion& m);
+
+    Motion slots[MOTION_MAX_SLOTS];
+};
@@ -0,0 +1,82 @@
+// Table-driven schedule store with precomputed transitions
+// Each device owns up to SCHED_MAX_WINDOWS daily windows with a weekday mask.
+// The next on/off transition of every device sits in a small min-heap, so
+// poll() is a single compare until a boundary is actually reached.
+//
+// An edge device (the feeder) is only told about the start of a window,
+// once: re-evaluation after invalidate() or a clock step never repeats it.
+//
+// Time is counted in minutes since 2000-01-01 00:00 (a Saturday), which is
+// what RtcDateTime::TotalSeconds() / 60 yields.
+
+#pragma once
+
+#include <Arduino.h>
+
+#define SCHED_MAX_DEVICES 4
+#define SCHED_MAX_WINDOWS 4
+#define SCHED_ALL_DAYS    0x7F   // bit 0 = Sunday ... bit 6 = Saturday
+#define SCHED_NEVER       0xFFFFFFFFUL
+
+#define MINUTES_PER_DAY   1440U
+
+struct ScheduleWindow {
+    uint16_t start;   // minute of day, inclusive
+    uint16_t end;     // minute of day, exclusive; end < start spans midnight
+    uint8_t days;     // weekday mask of the day the window starts on
+};
+
+// Called when a device's scheduled state may have changed
+typedef void (*ScheduleHandler)(uint8_t device, bool on);
+
+class ScheduleEngine {
+public:
+    ScheduleEngine();
+
+    // Window table editing. Changes take effect on the next poll().
+    bool setWindow(uint8_t device, uint8_t index, uint16_t start, uint16_t end,
+                   uint8_t days = SCHED_ALL_DAYS);
+    void clear(uint8_t device);
+    uint8_t windowCount(uint8_t device) const;
+    const ScheduleWindow& window(uint8_t device, uint8_t index) const;
+
+    // "HH:MM-HH:MM[@mask],..." with an optional hex weekday mask per window.
+    // Returns the number of windows loaded, or -1 on a syntax error.
+    int parse(uint8_t device, const char* text);
+    int parse(uint8_t device, const char* text, size_t len);   // not NUL-terminated
+    // Writes the windows in the same syntax (mask omitted for every-day)
+    size_t format(uint8_t device, char* buf, size_t len) const;
+
+    bool isOn(uint8_t device, uint32_t minute) const;
+
+    // Forces the device to be re-evaluated on the next poll()
+    void invalidate(uint8_t device);
+
+    // Edge devices get handler(device, true) once per window start instead
+    // of their level whenever it is re-evaluated
+    void setEdge(uint8_t device, bool edge);
+
+    // Dispatches every transition due at or before `minute`
+    void poll(uint32_t minute, ScheduleHandler handler);
+
+    uint32_t nextTransition(uint8_t device) const;
+
+private:
+    struct Entry {
+        uint32_t at;
+        uint8_t device;
+    };
+
+    uint32_t computeNext(uint8_t device, uint32_t minute) const;
+    void siftDown(uint8_t i);
+    void siftUp(uint8_t i);
+    int8_t find(uint8_t device) const;
+    void setEntry(uint8_t device, uint32_t at);
+
+    ScheduleWindow windows[SCHED_MAX_DEVICES][SCHED_MAX_WINDOWS];
+    uint8_t counts[SCHED_MAX_DEVICES];
+    Entry heap[SCHED_MAX_DEVICES];
+    bool edge[SCHED_MAX_DEVICES];
+    uint32_t lastEdge[SCHED_MAX_DEVICES];   // window start last reported on
+    uint32_t lastPoll;
+};
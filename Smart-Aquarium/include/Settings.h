@@ -0,0 +1,64 @@
+// Persistent automation settings in NVS
+// Schedules, manual overrides and the feed time are kept as one blob under a
+// single Preferences key, so a save is one NVS entry write. Saves are
+// debounced: a burst of edits (a Blynk slider, several MQTT messages) turns
+// into one write once things have been quiet for SETTINGS_DEBOUNCE_MS, and a
+// commit is forced after SETTINGS_MAX_DELAY_MS even if edits keep coming.
+// A commit that would store what is already in flash is skipped.
+
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "Schedule.h"
+
+#define SETTINGS_NAMESPACE     "aquarium"
+#define SETTINGS_KEY           "state"
+#define SETTINGS_VERSION       1         // bump when AquariumSettings changes layout
+#define SETTINGS_DEBOUNCE_MS   5000UL
+#define SETTINGS_MAX_DELAY_MS  60000UL
+
+struct AquariumSettings {
+    uint8_t version;
+    uint8_t counts[SCHED_MAX_DEVICES];
+    ScheduleWindow windows[SCHED_MAX_DEVICES][SCHED_MAX_WINDOWS];
+    uint8_t overrides;   // bit per schedule device under manual control
+    uint8_t manual;      // its manual on/off state (only meaningful with the override bit)
+};
+
+struct SettingsStats {
+    uint32_t saves;      // save() calls that changed something
+    uint32_t writes;     // NVS commits
+    uint32_t skipped;    // commits avoided because flash already matched
+};
+
+class SettingsStore {
+public:
+    SettingsStore(uint32_t debounceMs = SETTINGS_DEBOUNCE_MS, uint32_t maxDelayMs = SETTINGS_MAX_DELAY_MS);
+
+    // Opens the namespace and loads the stored blob. Returns false (and
+    // leaves `out` untouched) when nothing valid has been saved yet.
+    bool begin(AquariumSettings& out);
+
+    // Records the current settings; written later by update()
+    void save(const AquariumSettings& s);
+
+    // Call from loop(): commits once the debounce (or max delay) has expired
+    void update(uint32_t nowMs);
+    void flush();
+
+    bool pending() const { return dirty; }
+    const SettingsStats& stats() const { return counters; }
+
+private:
+    Preferences prefs;
+    uint32_t debounceMs;
+    uint32_t maxDelayMs;
+    AquariumSettings current;
+    AquariumSettings stored;
+    bool opened;
+    bool dirty;
+    uint32_t firstDirtyAt;
+    uint32_t lastDirtyAt;
+    SettingsStats counters;
+};
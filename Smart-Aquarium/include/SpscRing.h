@@ -0,0 +1,51 @@
+// Lock-free single-producer / single-consumer ring buffer
+// One task pushes, one task pops; no locks or critical sections are taken,
+// so a slow producer can never stall the consumer (or the other way round).
+// N must be a power of two; one slot is kept free to tell full from empty.
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+template <typename T, uint16_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    SpscRing() : head(0), tail(0), dropped(0) {}
+
+    // Producer side. Returns false (and counts a drop) when full.
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t next = (h + 1) & (N - 1);
+        if (next == tail.load(std::memory_order_acquire)) {
+            dropped++;
+            return false;
+        }
+        slots[h] = item;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when empty.
+    bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        item = slots[t];
+        tail.store((t + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+    uint32_t drops() const { return dropped; }
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    uint32_t dropped;   // written by the producer only
+};
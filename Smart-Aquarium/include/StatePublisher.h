@@ -0,0 +1,65 @@
+// Coalesced MQTT state reporting
+// State changes are collected for a short window and then emitted as one
+// retained JSON snapshot on aquarium/state. The legacy per-topic messages
+// (aquarium/state/pump, ...) are off by default; setPerTopic(true) adds them
+// for Node-RED flows that still read them, at the cost of the saving (only
+// the last value of each field within a window goes out).
+
+#pragma once
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+
+#define STATE_TOPIC          "aquarium/state"
+#define STATE_WINDOW_MS      250    // default coalescing window
+#define STATE_VALUE_LEN      64
+#define STATE_SNAPSHOT_LEN   512
+
+enum StateField : uint8_t {
+    STATE_PUMP = 0,
+    STATE_HEATER,
+    STATE_LED,
+    STATE_FEED,
+    STATE_LED_PROGRESS,
+    STATE_FEED_PROGRESS,
+    STATE_SCHEDULE_PUMP,
+    STATE_SCHEDULE_HEATER,
+    STATE_SCHEDULE_LED,
+    STATE_FIELD_COUNT
+};
+
+struct StatePublisherStats {
+    uint32_t changes;      // publishes the direct one-topic-per-change scheme would have made
+    uint32_t snapshots;
+    uint32_t perTopic;
+    int32_t saved() const { return (int32_t)changes - (int32_t)(snapshots + perTopic); }
+};
+
+class StatePublisher {
+public:
+    StatePublisher(PubSubClient& client, uint16_t windowMs = STATE_WINDOW_MS, bool perTopic = false);
+
+    void setWindow(uint16_t ms) { windowMs = ms; }
+    void setPerTopic(bool on) { perTopic = on; }
+
+    // Records a new value; nothing is sent until the window closes
+    void set(StateField field, const char* value);
+    const char* get(StateField field) const { return values[field]; }
+
+    // Call from loop(): flushes once the window has elapsed and MQTT is up
+    void update(uint32_t nowMs);
+    void flush();
+
+    const StatePublisherStats& stats() const { return counters; }
+
+private:
+    size_t buildSnapshot(char* buf, size_t len) const;
+
+    PubSubClient& client;
+    uint16_t windowMs;
+    bool perTopic;
+    char values[STATE_FIELD_COUNT][STATE_VALUE_LEN];
+    uint16_t dirty;           // bit per StateField
+    uint32_t firstDirtyAt;
+    StatePublisherStats counters;
+};
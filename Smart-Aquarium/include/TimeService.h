@@ -0,0 +1,55 @@
+// Cached wall-clock time
+// The DS1302 is read once at boot; afterwards time is extrapolated from
+// esp_timer, which costs a few instructions instead of a bit-banged
+// ThreeWire transaction. Every resync interval the clock is re-disciplined
+// against NTP (when SNTP has time, written back to the RTC) or the RTC.
+//
+// All times are seconds since 2000-01-01 00:00 local time, the same epoch
+// RtcDateTime uses. now() may be called from any task: the base pair is
+// only read and written under a critical section.
+
+#pragma once
+
+#include <Arduino.h>
+#include <RtcDS1302.h>
+
+#define TIME_RESYNC_MS      3600000UL   // default re-discipline interval
+#define TIME_NTP_RETRY_MS   10000UL     // until SNTP delivers a first time
+#define TIME_RTC_DRIFT_MAX  2           // seconds before the RTC is rewritten
+#define TIME_VALID_UNIX     1577836800  // 2020-01-01: older means SNTP has not set the clock
+
+class TimeService {
+public:
+    TimeService(RtcDS1302<ThreeWire>& rtc, uint32_t resyncMs = TIME_RESYNC_MS);
+
+    void begin();                       // single RTC read
+    void update();                      // call from loop(); cheap until a resync is due
+    void setResyncInterval(uint32_t ms) { resyncMs = ms; }
+
+    // Steps the clock, optionally writing the RTC as well
+    void set(uint32_t seconds, bool writeRtc);
+
+    uint32_t now() const;               // seconds since 2000
+    uint32_t epochMinute() const { return now() / 60; }
+    uint16_t minuteOfDay() const { return (now() / 60) % 1440; }
+    uint8_t hour() const { return minuteOfDay() / 60; }
+    uint8_t minute() const { return minuteOfDay() % 60; }
+    RtcDateTime dateTime() const { return RtcDateTime(now()); }
+
+    bool ntpSynced() const { return ntpOk; }
+    int32_t lastCorrection() const;     // seconds, at last resync
+
+private:
+    bool syncFromNtp();
+    void syncFromRtc();
+
+    RtcDS1302<ThreeWire>& rtc;
+    uint32_t resyncMs;
+    uint32_t baseSeconds;
+    int64_t baseUs;
+    uint32_t lastSync;
+    uint32_t lastNtpTry;
+    bool ntpOk;
+    int32_t correction;
+    mutable portMUX_TYPE lock;
+};
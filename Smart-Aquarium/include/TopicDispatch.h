@@ -0,0 +1,56 @@
+// Allocation-free MQTT command decoding
+// Topic suffixes under aquarium/set/ are hashed (FNV-1a) at compile time and
+// dispatched through a switch; a duplicate hash would be a duplicate case
+// label, so the table is guaranteed collision-free when it compiles. The
+// matched literal is still compared once to reject unknown topics.
+
+#pragma once
+
+#include <Arduino.h>
+#include <string.h>
+
+#define TOPIC_SET_PREFIX     "aquarium/set/"
+#define TOPIC_SET_PREFIX_LEN (sizeof(TOPIC_SET_PREFIX) - 1)
+
+enum AquariumCommand : uint8_t {
+    CMD_NONE = 0,
+    CMD_PUMP,
+    CMD_HEATER,
+    CMD_LED,
+    CMD_FEED,
+    CMD_OVERRIDE_RESET,
+    CMD_SCHEDULE_PUMP,
+    CMD_SCHEDULE_HEATER,
+    CMD_SCHEDULE_LED
+};
+
+constexpr uint32_t topicHash(const char* s, uint32_t h = 2166136261u) {
+    return *s ? topicHash(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+}
+
+#define TOPIC_CASE(suffix, cmd) \
+    case topicHash(suffix): return strcmp(s, suffix) == 0 ? cmd : CMD_NONE
+
+inline AquariumCommand decodeTopic(const char* topic) {
+    if (strncmp(topic, TOPIC_SET_PREFIX, TOPIC_SET_PREFIX_LEN) != 0) return CMD_NONE;
+    const char* s = topic + TOPIC_SET_PREFIX_LEN;
+
+    switch (topicHash(s)) {
+        TOPIC_CASE("pump",            CMD_PUMP);
+        TOPIC_CASE("heater",          CMD_HEATER);
+        TOPIC_CASE("led",             CMD_LED);
+        TOPIC_CASE("feed",            CMD_FEED);
+        TOPIC_CASE("override/reset",  CMD_OVERRIDE_RESET);
+        TOPIC_CASE("schedule/pump",   CMD_SCHEDULE_PUMP);
+        TOPIC_CASE("schedule/heater", CMD_SCHEDULE_HEATER);
+        TOPIC_CASE("schedule/led",    CMD_SCHEDULE_LED);
+        default: return CMD_NONE;
+    }
+}
+
+#undef TOPIC_CASE
+
+// Compares a non-terminated payload with a literal, e.g. payloadIs(p, n, "ON")
+inline bool payloadIs(const byte* payload, unsigned int length, const char* literal) {
+    return strlen(literal) == length && memcmp(payload, literal, length) == 0;
+}
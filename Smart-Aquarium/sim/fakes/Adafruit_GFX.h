@@ -0,0 +1,2 @@
+#pragma once
+// Text rendering is folded into the fake Adafruit_SSD1306
@@ -0,0 +1,58 @@
+// Host fake of Adafruit_SSD1306: keeps a real 1 KB framebuffer and a
+// text transcript of the last frame. Text is "rendered" as one byte per
+// character cell so the paged driver sees realistic frame diffs.
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_PAGEADDR     0x22
+#define SSD1306_COLUMNADDR   0x21
+#define SSD1306_WHITE        1
+#define SSD1306_BLACK        0
+#define WHITE                SSD1306_WHITE
+#define BLACK                SSD1306_BLACK
+
+class Adafruit_SSD1306 : public Print {
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1,
+                     uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+    ~Adafruit_SSD1306();
+
+    bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0,
+               bool reset = true, bool periphBegin = true);
+    void display();
+    void clearDisplay();
+    uint8_t* getBuffer() { return buffer; }
+
+    void setTextSize(uint8_t s) { textSize = s ? s : 1; }
+    void setTextColor(uint16_t) {}
+    void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+    int16_t width() const { return WIDTH; }
+    int16_t height() const { return HEIGHT; }
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    const char* transcript() const { return text; }
+
+protected:
+    void ssd1306_command1(uint8_t c);
+    void ssd1306_commandList(const uint8_t* c, uint8_t n);
+
+    const int16_t WIDTH;
+    const int16_t HEIGHT;
+    TwoWire* wire;
+    uint8_t* buffer;
+    int8_t i2caddr;
+    uint32_t wireClk;
+    uint32_t restoreClk;
+
+private:
+    int16_t cursorX = 0, cursorY = 0;
+    uint8_t textSize = 1;
+    char text[512];
+    size_t textLen = 0;
+};
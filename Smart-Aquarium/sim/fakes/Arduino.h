@@ -0,0 +1,91 @@
+// Host fake of the ESP32 Arduino core (subset used by Smart-Aquarium)
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+
+#include "SimHal.h"
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0x01
+#define OUTPUT  0x03
+#define INPUT_PULLUP 0x05
+#define IRAM_ATTR
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolution);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcDetachPin(uint8_t pin);
+void ledcWrite(uint8_t channel, uint32_t duty);
+
+uint32_t esp_random();
+size_t strlcpy(char* dst, const char* src, size_t size);
+
+void configTime(long gmtOffset, int dstOffset, const char* server1, const char* server2 = nullptr);
+
+// No SNTP in the simulator: the system clock reads as never set (1970)
+extern "C" time_t sim_time(time_t* out);
+#define time(out) sim_time(out)
+
+// ---------- Print / Serial ----------
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    size_t write(const char* s) { size_t n = 0; while (*s) n += write((uint8_t)*s++); return n; }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+    size_t println() { return write((uint8_t)'\n'); }
+    template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    size_t println(double v, int digits) { size_t n = print(v, digits); return n + println(); }
+};
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override;
+    using Print::write;
+};
+extern HardwareSerial Serial;
+
+// ---------- FreeRTOS ----------
+typedef void* TaskHandle_t;
+typedef uint32_t TickType_t;
+#define portTICK_PERIOD_MS 1
+#define pdPASS 1
+int xTaskCreatePinnedToCore(void (*fn)(void*), const char* name, uint32_t stack, void* param,
+                            unsigned prio, TaskHandle_t* handle, int core);
+void vTaskDelay(TickType_t ticks);
+
+// One thread runs both "cores": critical sections are no-ops
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux)  ((void)(mux))
@@ -0,0 +1,65 @@
+// Host fake of the Blynk ESP32 client. BLYNK_WRITE handlers are registered
+// so the simulator can drive virtual pins with sim_blynkWrite().
+#pragma once
+
+#include <Arduino.h>
+
+#define V0  0
+#define V1  1
+#define V2  2
+#define V3  3
+#define V10 10
+#define V11 11
+#define V12 12
+
+class BlynkParam {
+public:
+    class iterator {
+    public:
+        iterator(const char* p) : ptr(p) {}
+        bool isValid() const { return ptr != nullptr; }
+        bool isEmpty() const { return !ptr || !*ptr; }
+        const char* asStr() const { return ptr ? ptr : ""; }
+        int asInt() const { return ptr ? atoi(ptr) : 0; }
+        long asLong() const { return ptr ? atol(ptr) : 0; }
+    private:
+        const char* ptr;
+    };
+
+    // Values are '\0'-separated, like the real wire format
+    BlynkParam(const char* values, size_t len) : buf(values), len(len) {}
+    iterator operator[](int index) const;
+    int asInt() const { return (*this)[0].asInt(); }
+    long asLong() const { return (*this)[0].asLong(); }
+    const char* asStr() const { return (*this)[0].asStr(); }
+
+private:
+    const char* buf;
+    size_t len;
+};
+
+typedef void (*BlynkWriteHandler)(BlynkParam& param);
+
+struct SimBlynkRegistrar {
+    SimBlynkRegistrar(int pin, BlynkWriteHandler fn);
+};
+
+#define BLYNK_WRITE(pin) \
+    void BlynkWidgetWrite_##pin(BlynkParam& param); \
+    static SimBlynkRegistrar blynkRegistrar_##pin(pin, BlynkWidgetWrite_##pin); \
+    void BlynkWidgetWrite_##pin(BlynkParam& param)
+
+class BlynkClass {
+public:
+    void config(const char*) { configured = true; }
+    bool run();
+    bool connected() const { return online && sim_wifiAvailable; }
+    void virtualWrite(int pin, int value);
+private:
+    bool configured = false;
+    bool online = false;
+};
+extern BlynkClass Blynk;
+
+// Simulator entry: deliver a write to a virtual pin ('\0'-separated values)
+void sim_blynkWrite(int pin, const char* values, size_t len);
@@ -0,0 +1,17 @@
+// Host fake of ESP32Servo; logs attach/detach and sweep endpoints
+#pragma once
+
+#include <Arduino.h>
+
+class Servo {
+public:
+    int attach(int pin);
+    void detach();
+    void write(int angle);
+    int read() const { return angle; }
+    bool attached() const { return pin >= 0; }
+private:
+    int pin = -1;
+    int angle = 0;
+    int lastDir = 0;
+};
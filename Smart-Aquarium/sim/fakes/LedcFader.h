@@ -0,0 +1,55 @@
+// Host fake of lib/LedcFade: ramps play out on the virtual clock and are
+// stepped by read() with ledcWrite(), so they show up in the LEDC log. A
+// new chain takes over at once instead of after the running ramp.
+#pragma once
+
+#include <Arduino.h>
+
+#define FADE_MAX_CHANNELS   16
+#define FADE_MAX_RAMPS      4
+
+struct FadeRamp {
+    uint16_t duty;
+    uint16_t ms;
+};
+
+struct FadeEvent {
+    uint8_t channel;
+    uint8_t ramp;
+    uint8_t count;
+    uint16_t duty;
+    bool done;
+};
+
+struct FadeStats {
+    uint32_t ramps;
+    uint32_t rampMs;
+    uint32_t wakeups;
+    uint32_t busyUs;
+};
+
+class LedcFader {
+public:
+    bool begin() { return true; }
+    bool attach(uint8_t channel, uint8_t resolutionBits);
+    bool play(uint8_t channel, const FadeRamp* ramps, uint8_t count, bool repeat = false);
+    bool fadeTo(uint8_t channel, uint16_t duty, uint16_t fullScaleMs, uint8_t parts = 1);
+    bool read(FadeEvent& out);
+    FadeStats stats() const { return counters; }
+
+private:
+    struct Channel {
+        bool attached = false;
+        bool active = false;
+        uint16_t maxDuty = 0;
+        FadeRamp ramps[FADE_MAX_RAMPS];
+        uint8_t count = 0;
+        uint8_t index = 0;
+        bool repeat = false;
+        uint16_t from = 0;
+        uint32_t startMs = 0;
+    };
+
+    Channel channels[FADE_MAX_CHANNELS];
+    FadeStats counters = { 0, 0, 0, 0 };
+};
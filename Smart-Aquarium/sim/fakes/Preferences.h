@@ -0,0 +1,21 @@
+// Host fake of the ESP32 Preferences (NVS) library
+// Entries live in memory; with sim_nvsFile set they are loaded from and
+// written back to that file, so a second run sees the first run's flash.
+#pragma once
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end() {}
+
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+    size_t getBytesLength(const char* key);
+    bool remove(const char* key);
+    bool clear();
+
+private:
+    char ns[16] = "";
+};
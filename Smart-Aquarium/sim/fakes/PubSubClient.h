@@ -0,0 +1,27 @@
+// Host fake of PubSubClient; counts publishes and delivers injected messages
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#define MQTT_CALLBACK_SIGNATURE void (*callback)(char*, uint8_t*, unsigned int)
+
+class PubSubClient {
+public:
+    explicit PubSubClient(Client&) {}
+    PubSubClient& setServer(const char*, uint16_t) { return *this; }
+    PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE) { this->callback = callback; return *this; }
+    bool setBufferSize(uint16_t) { return true; }
+    PubSubClient& setSocketTimeout(uint16_t) { return *this; }
+
+    bool connect(const char* id);
+    bool connected() const { return isConnected && sim_brokerAvailable && sim_wifiAvailable; }
+    bool subscribe(const char*) { return connected(); }
+    bool publish(const char* topic, const char* payload, bool retained = false);
+    bool loop();
+    int state() const { return connected() ? 0 : -2; }
+
+private:
+    MQTT_CALLBACK_SIGNATURE = nullptr;
+    bool isConnected = false;
+};
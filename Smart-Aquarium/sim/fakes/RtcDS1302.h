@@ -0,0 +1,40 @@
+// Host fake of Makuna's RtcDS1302; the chip follows the virtual clock
+#pragma once
+
+#include <Arduino.h>
+
+class RtcDateTime {
+public:
+    RtcDateTime(uint32_t secondsFrom2000 = 0) : seconds(secondsFrom2000) {}
+    RtcDateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
+
+    uint32_t TotalSeconds() const { return seconds; }
+    uint16_t Year() const;
+    uint8_t Month() const;
+    uint8_t Day() const;
+    uint8_t Hour() const { return (seconds / 3600) % 24; }
+    uint8_t Minute() const { return (seconds / 60) % 60; }
+    uint8_t Second() const { return seconds % 60; }
+    uint8_t DayOfWeek() const { return (seconds / 86400 + 6) % 7; }   // 2000-01-01 = Saturday
+
+private:
+    uint32_t seconds;
+};
+
+class ThreeWire {
+public:
+    ThreeWire(uint8_t, uint8_t, uint8_t) {}
+};
+
+uint32_t sim_rtcRead();
+void sim_rtcWrite(uint32_t seconds);
+
+template <typename T>
+class RtcDS1302 {
+public:
+    explicit RtcDS1302(T&) {}
+    void Begin() {}
+    bool GetIsRunning() { return true; }
+    RtcDateTime GetDateTime() { return RtcDateTime(sim_rtcRead()); }
+    void SetDateTime(const RtcDateTime& dt) { sim_rtcWrite(dt.TotalSeconds()); }
+};
@@ -0,0 +1,29 @@
+// Host-simulation HAL: virtual clock, hardware event log and fault/input
+// injection shared by the fake Arduino/ESP32 headers in this directory.
+
+#pragma once
+
+#include <stdint.h>
+
+// ---------- Virtual clock ----------
+extern uint64_t sim_us;                  // virtual time since boot
+extern uint32_t sim_epoch;               // RTC seconds since 2000 at boot
+void sim_advance(uint64_t us);
+
+// ---------- Hardware activity ----------
+// Set by any GPIO/LEDC/servo write; the driver uses it to shorten its step
+extern bool sim_activity;
+void sim_event(const char* device, const char* fmt, ...);   // logs with virtual time
+extern bool sim_trace;                   // print every event as it happens
+
+// ---------- Network ----------
+extern bool sim_wifiAvailable;
+extern bool sim_brokerAvailable;
+extern uint32_t sim_mqttPublishes;
+extern uint32_t sim_mqttBytes;
+extern uint32_t sim_i2cBytes;
+void sim_mqttInject(const char* topic, const char* payload);
+
+// ---------- Flash ----------
+extern const char* sim_nvsFile;          // optional backing file for Preferences
+extern uint32_t sim_nvsWrites;
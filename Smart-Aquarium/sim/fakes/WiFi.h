@@ -0,0 +1,24 @@
+// Host fake of the ESP32 WiFi library
+#pragma once
+
+#include <Arduino.h>
+
+#define WL_IDLE_STATUS   0
+#define WL_CONNECTED     3
+#define WL_DISCONNECTED  6
+#define WIFI_STA         1
+
+class WiFiClass {
+public:
+    void mode(int) {}
+    void setAutoReconnect(bool) {}
+    void begin(const char*, const char*) { started = true; }
+    void disconnect() { started = false; }
+    int status() const { return started && sim_wifiAvailable ? WL_CONNECTED : WL_DISCONNECTED; }
+    const char* localIP() const { return "10.0.0.2"; }
+private:
+    bool started = false;
+};
+extern WiFiClass WiFi;
+
+#include <WiFiClient.h>
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <Arduino.h>
+
+class Client {};
+
+class WiFiClient : public Client {
+public:
+    int setTimeout(uint32_t) { return 0; }
+};
@@ -0,0 +1,15 @@
+// Host fake of the Arduino Wire (I2C) library; counts bytes on the bus
+#pragma once
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+    bool begin(int = -1, int = -1) { return true; }
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) { sim_i2cBytes++; }   // address byte
+    size_t write(uint8_t) { sim_i2cBytes++; return 1; }
+    size_t write(const uint8_t*, size_t n) { sim_i2cBytes += n; return n; }
+    uint8_t endTransmission(bool = true) { return 0; }
+};
+extern TwoWire Wire;
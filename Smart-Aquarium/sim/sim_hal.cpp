@@ -0,0 +1,496 @@
+// Implementation of the fake HAL in sim/fakes: a virtual clock shared by
+// millis()/micros()/esp_timer and the RTC, plus an event log of everything
+// the firmware does to the outside world.
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include <ESP32Servo.h>
+#include <PubSubClient.h>
+#include <RtcDS1302.h>
+#include <BlynkSimpleEsp32.h>
+#include <Preferences.h>
+#include <LedcFader.h>
+#include <esp_timer.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+/************ VIRTUAL CLOCK ************/
+uint64_t sim_us = 0;
+uint32_t sim_epoch = 0;
+
+static uint32_t rtcOffset = 0;   // RTC seconds at sim_us == 0
+
+void sim_advance(uint64_t us) { sim_us += us; }
+
+unsigned long millis() { return (unsigned long)(uint32_t)(sim_us / 1000); }
+unsigned long micros() { return (unsigned long)(uint32_t)sim_us; }
+void delay(uint32_t ms) { sim_advance((uint64_t)ms * 1000); }
+int64_t esp_timer_get_time() { return (int64_t)sim_us; }
+
+uint32_t sim_rtcRead() { return sim_epoch + rtcOffset + (uint32_t)(sim_us / 1000000); }
+void sim_rtcWrite(uint32_t seconds) { rtcOffset = seconds - sim_epoch - (uint32_t)(sim_us / 1000000); }
+
+void configTime(long, int, const char*, const char*) {}
+extern "C" time_t sim_time(time_t* out) {   // no SNTP: the RTC is the reference
+    if (out) *out = 0;
+    return 0;
+}
+
+uint32_t esp_random() {
+    static uint32_t state = 0x12345678;   // deterministic runs
+    state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+    return state;
+}
+
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+
+/************ EVENT LOG ************/
+bool sim_activity = false;
+bool sim_trace = false;
+
+void sim_event(const char* device, const char* fmt, ...) {
+    sim_activity = true;
+    if (!sim_trace) return;
+
+    uint32_t t = sim_rtcRead();
+    RtcDateTime dt(t);
+    char msg[96];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+    printf("%04u-%02u-%02u %02u:%02u:%02u  %-7s %s\n", dt.Year(), dt.Month(), dt.Day(),
+           dt.Hour(), dt.Minute(), dt.Second(), device, msg);
+}
+
+/************ GPIO / LEDC ************/
+static uint8_t pinLevel[40];
+static uint32_t ledcDuty[16];
+static int8_t ledcPin[16] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
+static int8_t ledcDir[16];
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= sizeof(pinLevel) || pinLevel[pin] == val) return;
+    pinLevel[pin] = val;
+    sim_event("GPIO", "pin %u -> %s", pin, val ? "HIGH" : "LOW");
+}
+
+int digitalRead(uint8_t pin) { return pin < sizeof(pinLevel) ? pinLevel[pin] : LOW; }
+
+uint32_t ledcSetup(uint8_t, uint32_t freq, uint8_t) { return freq; }
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (channel >= 16) return;
+    ledcPin[channel] = pin;
+    sim_event("LEDC", "ch %u attached to pin %u", channel, pin);
+}
+
+void ledcDetachPin(uint8_t pin) {
+    for (uint8_t ch = 0; ch < 16; ch++) {
+        if (ledcPin[ch] == pin) {
+            ledcPin[ch] = -1;
+            sim_event("LEDC", "ch %u detached", ch);
+        }
+    }
+}
+
+// Only the ends of a ramp are logged; every write still counts as activity
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= 16 || ledcDuty[channel] == duty) return;
+    int8_t dir = duty > ledcDuty[channel] ? 1 : -1;
+    if (dir != ledcDir[channel]) {
+        sim_event("LEDC", "ch %u ramp %s from %u", channel, dir > 0 ? "up" : "down", ledcDuty[channel]);
+    }
+    ledcDir[channel] = dir;
+    ledcDuty[channel] = duty;
+    sim_activity = true;
+    if (duty == 0 || duty == 255) sim_event("LEDC", "ch %u duty %u", channel, duty);
+}
+
+/************ LEDC FADE ************/
+bool LedcFader::attach(uint8_t channel, uint8_t resolutionBits) {
+    if (channel >= FADE_MAX_CHANNELS) return false;
+    channels[channel].attached = true;
+    channels[channel].maxDuty = (1U << resolutionBits) - 1;
+    return true;
+}
+
+bool LedcFader::play(uint8_t channel, const FadeRamp* ramps, uint8_t count, bool repeat) {
+    if (channel >= FADE_MAX_CHANNELS || !channels[channel].attached || !count || count > FADE_MAX_RAMPS) return false;
+    Channel& c = channels[channel];
+    memcpy(c.ramps, ramps, count * sizeof(FadeRamp));
+    c.count = count;
+    c.index = 0;
+    c.repeat = repeat;
+    c.from = ledcDuty[channel];
+    c.startMs = millis();
+    c.active = true;
+    counters.ramps++;
+    counters.rampMs += ramps[0].ms;
+    return true;
+}
+
+bool LedcFader::fadeTo(uint8_t channel, uint16_t duty, uint16_t fullScaleMs, uint8_t parts) {
+    if (channel >= FADE_MAX_CHANNELS || !channels[channel].attached) return false;
+    int32_t from = ledcDuty[channel];
+    int32_t to = min<int32_t>(duty, channels[channel].maxDuty);
+    parts = max<uint8_t>(1, min<uint8_t>(parts, FADE_MAX_RAMPS));
+    uint32_t ms = (uint32_t)abs(to - from) * fullScaleMs / channels[channel].maxDuty;
+    FadeRamp ramps[FADE_MAX_RAMPS];
+    for (uint8_t i = 0; i < parts; i++) {
+        ramps[i] = { (uint16_t)(from + (to - from) * (i + 1) / parts), (uint16_t)(ms / parts) };
+    }
+    return play(channel, ramps, parts);
+}
+
+bool LedcFader::read(FadeEvent& out) {
+    for (uint8_t ch = 0; ch < FADE_MAX_CHANNELS; ch++) {
+        Channel& c = channels[ch];
+        if (!c.active) continue;
+
+        const FadeRamp& r = c.ramps[c.index];
+        uint32_t elapsed = millis() - c.startMs;
+        if (elapsed < r.ms) {
+            ledcWrite(ch, c.from + ((int32_t)r.duty - c.from) * (int32_t)elapsed / r.ms);
+            sim_activity = true;
+            continue;
+        }
+
+        ledcWrite(ch, r.duty);
+        out = { ch, c.index, c.count, r.duty, false };
+        c.from = r.duty;
+        c.startMs += r.ms;
+        if (++c.index >= c.count) {
+            c.index = 0;
+            if (!c.repeat) {
+                c.active = false;
+                out.done = true;
+                return true;
+            }
+        }
+        counters.ramps++;
+        counters.rampMs += c.ramps[c.index].ms;
+        return true;
+    }
+    return false;
+}
+
+/************ SERIAL ************/
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (sim_trace) putchar(c);
+    return 1;
+}
+
+size_t Print::printf(const char* fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write(buf);
+}
+
+/************ FREERTOS ************/
+// The simulator calls the task bodies itself, so tasks are only recorded
+int xTaskCreatePinnedToCore(void (*)(void*), const char* name, uint32_t, void*,
+                            unsigned, TaskHandle_t* handle, int core) {
+    if (handle) *handle = (TaskHandle_t)name;
+    sim_event("RTOS", "task \"%s\" on core %d", name, core);
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t) {}
+
+/************ I2C / OLED ************/
+TwoWire Wire;
+uint32_t sim_i2cBytes = 0;
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t, uint32_t clkDuring, uint32_t clkAfter)
+    : WIDTH(w), HEIGHT(h), wire(twi), buffer(nullptr), i2caddr(0),
+      wireClk(clkDuring), restoreClk(clkAfter) {
+    text[0] = '\0';
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() { free(buffer); }
+
+bool Adafruit_SSD1306::begin(uint8_t, uint8_t addr, bool, bool) {
+    if (!buffer) buffer = (uint8_t*)calloc(1, WIDTH * ((HEIGHT + 7) / 8));
+    i2caddr = addr;
+    return buffer != nullptr;
+}
+
+// Stock driver: the whole framebuffer on every call
+void Adafruit_SSD1306::display() {
+    static const uint8_t window[] = { SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0 };
+    ssd1306_commandList(window, sizeof(window));
+    ssd1306_command1(WIDTH - 1);
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x40);
+    wire->write(buffer, WIDTH * ((HEIGHT + 7) / 8));
+    wire->endTransmission();
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+    memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+    textLen = 0;
+    text[0] = '\0';
+    cursorX = cursorY = 0;
+}
+
+// A 6x8 cell per character; the cell's columns get the glyph code so a
+// changed character changes the same bytes a real font would
+size_t Adafruit_SSD1306::write(uint8_t c) {
+    if (textLen < sizeof(text) - 1) {
+        text[textLen++] = c;
+        text[textLen] = '\0';
+    }
+    if (c == '\n') {
+        cursorX = 0;
+        cursorY += 8 * textSize;
+        return 1;
+    }
+    if (!buffer || cursorY >= HEIGHT) return 1;
+    for (uint8_t i = 0; i < 6 * textSize && cursorX + i < WIDTH; i++) {
+        buffer[(cursorY / 8) * WIDTH + cursorX + i] = (i < 5) ? (uint8_t)(c * (i + 1)) : 0;
+    }
+    cursorX += 6 * textSize;
+    return 1;
+}
+
+void Adafruit_SSD1306::ssd1306_command1(uint8_t c) {
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00);
+    wire->write(c);
+    wire->endTransmission();
+}
+
+void Adafruit_SSD1306::ssd1306_commandList(const uint8_t* c, uint8_t n) {
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00);
+    wire->write(c, n);
+    wire->endTransmission();
+}
+
+/************ SERVO ************/
+int Servo::attach(int pin) {
+    if (this->pin != pin) sim_event("SERVO", "attach pin %d", pin);
+    this->pin = pin;
+    return 1;
+}
+
+void Servo::detach() {
+    if (pin >= 0) sim_event("SERVO", "detach at %d deg", angle);
+    pin = -1;
+    lastDir = 0;
+}
+
+void Servo::write(int a) {
+    if (a == angle) return;
+    int dir = a > angle ? 1 : -1;
+    if (dir != lastDir) sim_event("SERVO", "sweep %s from %d deg", dir > 0 ? "up" : "down", angle);
+    lastDir = dir;
+    angle = a;
+    sim_activity = true;
+}
+
+/************ RTC ************/
+static const uint8_t daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+static bool leapYear(uint16_t y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+
+RtcDateTime::RtcDateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second) {
+    uint32_t days = day - 1;
+    for (uint16_t y = 2000; y < year; y++) days += leapYear(y) ? 366 : 365;
+    for (uint8_t m = 1; m < month; m++) days += daysInMonth[m - 1] + (m == 2 && leapYear(year));
+    seconds = ((days * 24 + hour) * 60 + minute) * 60 + second;
+}
+
+// Civil date of the seconds count: walk years then months
+static void civil(uint32_t seconds, uint16_t& year, uint8_t& month, uint8_t& day) {
+    uint32_t days = seconds / 86400;
+    year = 2000;
+    while (days >= (leapYear(year) ? 366U : 365U)) days -= leapYear(year++) ? 366 : 365;
+    month = 1;
+    for (;;) {
+        uint8_t len = daysInMonth[month - 1] + (month == 2 && leapYear(year));
+        if (days < len) break;
+        days -= len;
+        month++;
+    }
+    day = days + 1;
+}
+
+uint16_t RtcDateTime::Year() const { uint16_t y; uint8_t m, d; civil(seconds, y, m, d); return y; }
+uint8_t RtcDateTime::Month() const { uint16_t y; uint8_t m, d; civil(seconds, y, m, d); return m; }
+uint8_t RtcDateTime::Day() const { uint16_t y; uint8_t m, d; civil(seconds, y, m, d); return d; }
+
+/************ WIFI ************/
+WiFiClass WiFi;
+bool sim_wifiAvailable = true;
+
+/************ MQTT ************/
+bool sim_brokerAvailable = true;
+uint32_t sim_mqttPublishes = 0;
+uint32_t sim_mqttBytes = 0;
+
+struct SimMessage {
+    std::string topic;
+    std::string payload;
+};
+static std::vector<SimMessage> mqttInbox;
+
+void sim_mqttInject(const char* topic, const char* payload) {
+    mqttInbox.push_back({ topic, payload });
+}
+
+bool PubSubClient::connect(const char*) {
+    isConnected = sim_brokerAvailable && sim_wifiAvailable;
+    if (isConnected) sim_event("MQTT", "connected");
+    return isConnected;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, bool retained) {
+    if (!connected()) return false;
+    sim_mqttPublishes++;
+    sim_mqttBytes += strlen(topic) + strlen(payload) + 4;   // + fixed header / topic length
+    sim_event("MQTT", "%s%s %s", retained ? "(r) " : "", topic, payload);
+    return true;
+}
+
+// Delivers injected messages once connected, like a retained subscription
+bool PubSubClient::loop() {
+    if (!connected()) return false;
+    std::vector<SimMessage> inbox;
+    inbox.swap(mqttInbox);
+    for (SimMessage& m : inbox) {
+        sim_event("MQTT", "<- %s %s", m.topic.c_str(), m.payload.c_str());
+        if (callback) callback(&m.topic[0], (uint8_t*)&m.payload[0], m.payload.size());
+    }
+    return true;
+}
+
+/************ BLYNK ************/
+BlynkClass Blynk;
+static BlynkWriteHandler blynkHandlers[16];
+
+SimBlynkRegistrar::SimBlynkRegistrar(int pin, BlynkWriteHandler fn) {
+    if (pin >= 0 && pin < 16) blynkHandlers[pin] = fn;
+}
+
+BlynkParam::iterator BlynkParam::operator[](int index) const {
+    const char* p = buf;
+    const char* end = buf + len;
+    for (int i = 0; p < end; i++) {
+        if (i == index) return iterator(p);
+        p += strlen(p) + 1;
+    }
+    return iterator(nullptr);
+}
+
+bool BlynkClass::run() {
+    online = configured && sim_wifiAvailable;
+    return online;
+}
+
+void BlynkClass::virtualWrite(int pin, int value) {
+    if (connected()) sim_event("BLYNK", "V%d <- %d", pin, value);
+}
+
+void sim_blynkWrite(int pin, const char* values, size_t len) {
+    if (pin < 0 || pin >= 16 || !blynkHandlers[pin]) return;
+    BlynkParam param(values, len);
+    blynkHandlers[pin](param);
+}
+
+/************ NVS ************/
+const char* sim_nvsFile = nullptr;
+uint32_t sim_nvsWrites = 0;
+
+// "namespace/key" -> value; the file is a sequence of (name, value) records
+static std::map<std::string, std::string> nvs;
+
+static void nvsLoad() {
+    static bool loaded = false;
+    if (loaded || !sim_nvsFile) return;
+    loaded = true;
+    FILE* f = fopen(sim_nvsFile, "rb");
+    if (!f) return;
+    uint32_t lens[2];
+    while (fread(lens, sizeof(lens), 1, f) == 1) {
+        std::string name(lens[0], '\0'), value(lens[1], '\0');
+        if (fread(&name[0], 1, lens[0], f) != lens[0] || fread(&value[0], 1, lens[1], f) != lens[1]) break;
+        nvs[name] = value;
+    }
+    fclose(f);
+}
+
+static void nvsStore() {
+    if (!sim_nvsFile) return;
+    FILE* f = fopen(sim_nvsFile, "wb");
+    if (!f) return;
+    for (auto& e : nvs) {
+        uint32_t lens[2] = { (uint32_t)e.first.size(), (uint32_t)e.second.size() };
+        fwrite(lens, sizeof(lens), 1, f);
+        fwrite(e.first.data(), 1, e.first.size(), f);
+        fwrite(e.second.data(), 1, e.second.size(), f);
+    }
+    fclose(f);
+}
+
+bool Preferences::begin(const char* name, bool) {
+    nvsLoad();
+    strlcpy(ns, name, sizeof(ns));
+    return true;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    nvs[std::string(ns) + "/" + key].assign((const char*)value, len);
+    sim_nvsWrites++;
+    sim_event("NVS", "%s/%s %zu bytes", ns, key, len);
+    nvsStore();
+    return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    auto it = nvs.find(std::string(ns) + "/" + key);
+    if (it == nvs.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    auto it = nvs.find(std::string(ns) + "/" + key);
+    return it == nvs.end() ? 0 : it->second.size();
+}
+
+bool Preferences::remove(const char* key) {
+    bool found = nvs.erase(std::string(ns) + "/" + key) > 0;
+    nvsStore();
+    return found;
+}
+
+bool Preferences::clear() {
+    std::string prefix = std::string(ns) + "/";
+    for (auto it = nvs.begin(); it != nvs.end();) {
+        it = it->first.compare(0, prefix.size(), prefix) == 0 ? nvs.erase(it) : ++it;
+    }
+    nvsStore();
+    return true;
+}
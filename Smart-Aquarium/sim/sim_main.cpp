@@ -0,0 +1,140 @@
+// Host driver for the Smart Aquarium firmware
+// Runs the unmodified setup()/loop() and the network task body against the
+// fakes in sim/fakes on a virtual clock, so days of schedules, overrides and
+// reconnects play out in seconds. While anything is moving (LED fade, feeder
+// sweep) the clock advances in small steps; otherwise it jumps by --step.
+//
+//   aquarium_sim [--days N] [--step MS] [--start YYYY-MM-DD HH:MM] [--offline] [--quiet]
+//                [--nvs FILE]   keep NVS in FILE; a second run restores from it
+
+#include <Arduino.h>
+#include <BlynkSimpleEsp32.h>
+#include <RtcDS1302.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+void setup();
+void loop();
+void networkStep();
+void updateDisplay();
+
+#define SIM_ACTIVE_STEP_MS 10
+
+struct LatencyStats {
+    std::vector<uint32_t> samples;   // host nanoseconds
+
+    void add(uint32_t ns) { samples.push_back(ns); }
+    void print(const char* name) {
+        if (samples.empty()) return;
+        std::sort(samples.begin(), samples.end());
+        uint64_t sum = 0;
+        for (uint32_t s : samples) sum += s;
+        printf("  %-16s n=%-9zu avg %6llu ns  p50 %6u ns  p99 %7u ns  max %8u ns\n", name, samples.size(),
+               (unsigned long long)(sum / samples.size()), samples[samples.size() / 2],
+               samples[samples.size() * 99 / 100], samples.back());
+    }
+};
+
+template <typename F>
+static uint32_t timed(F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+}
+
+// Scripted inputs: virtual second since boot -> action, in time order
+struct SimInput {
+    uint32_t at;
+    void (*fire)();
+};
+
+static void sendSchedules() {
+    sim_mqttInject("aquarium/set/schedule/pump", "08:00-20:00");
+    sim_mqttInject("aquarium/set/schedule/heater", "22:00-06:00");
+    sim_mqttInject("aquarium/set/schedule/led", "09:00-12:00,14:00-21:00@3E");
+}
+static void manualPumpOff() { sim_mqttInject("aquarium/set/pump", "OFF"); }
+static void blynkLedOn()    { sim_blynkWrite(V2, "1", 2); }
+static void resetOverride() { sim_mqttInject("aquarium/set/override/reset", "1"); }
+static void brokerDown()    { sim_brokerAvailable = false; }
+static void brokerUp()      { sim_brokerAvailable = true; }
+
+static const SimInput script[] = {
+    { 5,               sendSchedules },
+    { 5 * 3600 + 1800, blynkLedOn },      // 12:30 day 1, inside the LED gap
+    { 6 * 3600,        manualPumpOff },   // 13:00 day 1
+    { 9 * 3600,        resetOverride },
+    { 30 * 3600,       brokerDown },      // 13:00 day 2, for two hours
+    { 32 * 3600,       brokerUp },
+};
+
+int main(int argc, char** argv) {
+    uint32_t days = 7;
+    uint32_t stepMs = 1000;
+    RtcDateTime start(2024, 1, 1, 7, 0, 0);
+    sim_trace = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--days") && i + 1 < argc) {
+            days = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--step") && i + 1 < argc) {
+            stepMs = max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--start") && i + 2 < argc) {
+            unsigned y, mo, d, h, mi;
+            if (sscanf(argv[i + 1], "%u-%u-%u", &y, &mo, &d) != 3 || sscanf(argv[i + 2], "%u:%u", &h, &mi) != 2) {
+                fprintf(stderr, "bad --start, expected YYYY-MM-DD HH:MM\n");
+                return 1;
+            }
+            start = RtcDateTime(y, mo, d, h, mi, 0);
+            i += 2;
+        } else if (!strcmp(argv[i], "--nvs") && i + 1 < argc) {
+            sim_nvsFile = argv[++i];
+        } else if (!strcmp(argv[i], "--offline")) {
+            sim_wifiAvailable = false;
+        } else if (!strcmp(argv[i], "--quiet")) {
+            sim_trace = false;
+        } else {
+            fprintf(stderr, "usage: %s [--days N] [--step MS] [--start YYYY-MM-DD HH:MM] [--offline] [--quiet] [--nvs FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    sim_epoch = start.TotalSeconds();
+
+    LatencyStats controlStats, networkStats, displayStats;
+    size_t nextInput = 0;
+    const uint64_t endUs = (uint64_t)days * 86400ULL * 1000000ULL;
+
+    auto wall0 = std::chrono::steady_clock::now();
+    setup();
+
+    while (sim_us < endUs) {
+        uint32_t second = sim_us / 1000000;
+        while (nextInput < sizeof(script) / sizeof(script[0]) && script[nextInput].at <= second) {
+            script[nextInput++].fire();
+        }
+
+        sim_activity = false;
+        controlStats.add(timed(loop));
+        networkStats.add(timed(networkStep));
+        displayStats.add(timed(updateDisplay));
+
+        // Step finely while the firmware is driving hardware, coarsely otherwise
+        sim_advance((uint64_t)(sim_activity ? SIM_ACTIVE_STEP_MS : stepMs) * 1000);
+    }
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+
+    printf("\n=== %u simulated day(s) in %.2f s host time (%.0fx real time) ===\n",
+           days, wallS, (endUs / 1e6) / wallS);
+    printf("Host latency per pass:\n");
+    controlStats.print("loop()");
+    networkStats.print("networkStep()");
+    displayStats.print("updateDisplay()");
+    printf("MQTT: %u publishes, %u bytes\n", sim_mqttPublishes, sim_mqttBytes);
+    printf("OLED: %u bytes over I2C\n", sim_i2cBytes);
+    printf("NVS: %u writes\n", sim_nvsWrites);
+    return 0;
+}
@@ -0,0 +1,79 @@
+#ifdef AQUARIUM_BENCH
+
+#include <Arduino.h>
+#include "Benchmarks.h"
+#include "TopicDispatch.h"
+
+#define BENCH_ROUNDS 2000
+
+struct BenchMessage {
+    const char* topic;
+    const char* payload;
+};
+
+static const BenchMessage messages[] = {
+    { "aquarium/set/pump",            "ON" },
+    { "aquarium/set/heater",          "OFF" },
+    { "aquarium/set/led",             "ON" },
+    { "aquarium/set/feed",            "1" },
+    { "aquarium/set/override/reset",  "" },
+    { "aquarium/set/schedule/led",    "08:00-12:00,18:00-22:00" },
+    { "aquarium/status/unknown",      "x" },
+};
+static const uint8_t numMessages = sizeof(messages) / sizeof(messages[0]);
+
+// The pre-dispatch-table callback, minus the side effects
+static uint8_t legacyDecode(char* topic, byte* payload, unsigned int length, bool& on) {
+    String msg;
+    for (int i = 0; i < length; i++) msg += (char)payload[i];
+    String t = String(topic);
+    on = msg == "ON";
+
+    if (t == "aquarium/set/pump") return CMD_PUMP;
+    else if (t == "aquarium/set/heater") return CMD_HEATER;
+    else if (t == "aquarium/set/led") return CMD_LED;
+    else if (t == "aquarium/set/feed") return CMD_FEED;
+    else if (t == "aquarium/set/override/reset") return CMD_OVERRIDE_RESET;
+    else if (t == "aquarium/set/schedule/pump") return CMD_SCHEDULE_PUMP;
+    else if (t == "aquarium/set/schedule/heater") return CMD_SCHEDULE_HEATER;
+    else if (t == "aquarium/set/schedule/led") return CMD_SCHEDULE_LED;
+    return CMD_NONE;
+}
+
+static uint8_t tableDecode(char* topic, byte* payload, unsigned int length, bool& on) {
+    on = payloadIs(payload, length, "ON");
+    return decodeTopic(topic);
+}
+
+typedef uint8_t (*DecodeFn)(char*, byte*, unsigned int, bool&);
+
+static void benchDecode(const char* name, DecodeFn fn) {
+    volatile uint32_t sink = 0;
+    uint32_t heapBefore = ESP.getFreeHeap();
+    uint32_t minHeap = heapBefore;
+    uint32_t start = ESP.getCycleCount();
+
+    for (uint16_t r = 0; r < BENCH_ROUNDS; r++) {
+        for (uint8_t i = 0; i < numMessages; i++) {
+            bool on;
+            sink += fn((char*)messages[i].topic, (byte*)messages[i].payload,
+                       strlen(messages[i].payload), on) + on;
+        }
+        if ((r & 63) == 0) minHeap = min<uint32_t>(minHeap, ESP.getFreeHeap());
+    }
+
+    uint32_t cycles = ESP.getCycleCount() - start;
+    uint32_t perMsg = cycles / ((uint32_t)BENCH_ROUNDS * numMessages);
+    Serial.printf("  %-8s %5lu cycles/msg (%.2f us)  heap low-water delta %lu B\n",
+                  name, (unsigned long)perMsg, perMsg / (float)ESP.getCpuFreqMHz(),
+                  (unsigned long)(heapBefore - minHeap));
+    (void)sink;
+}
+
+void runBenchmarks() {
+    Serial.println("MQTT command decode:");
+    benchDecode("legacy", legacyDecode);
+    benchDecode("table", tableDecode);
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include "MotionEngine.h"
+
+MotionEngine::MotionEngine() {
+    for (uint8_t i = 0; i < MOTION_MAX_SLOTS; i++) {
+        slots[i] = Motion();
+        slots[i].kind = MOTION_IDLE;
+    }
+}
+
+bool MotionEngine::begin(uint8_t slot, const int16_t* waypoints, uint8_t n,
+                         uint8_t step, uint16_t stepMs, MotionCallback cb) {
+    if (slot >= MOTION_MAX_SLOTS || n < 2 || n > MOTION_MAX_WAYPOINTS || step == 0) return false;
+
+    Motion& m = slots[slot];
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        m.waypoints[i] = waypoints[i];
+        if (i > 0) {
+            int16_t dist = abs(waypoints[i] - waypoints[i - 1]);
+            total += (dist + step - 1) / step;
+        }
+    }
+    m.numWaypoints = n;
+    m.target = 1;
+    m.position = waypoints[0];
+    m.stepSize = step;
+    m.stepMs = stepMs ? stepMs : 1;
+    m.lastStep = millis();
+    m.stepsDone = 0;
+    m.stepsTotal = total;
+    m.lastReported = 0;
+    m.cb = cb;
+    return true;
+}
+
+bool MotionEngine::startServo(uint8_t slot, Servo& servo, const int16_t* waypoints, uint8_t n,
+                              uint8_t step, uint16_t stepMs, MotionCallback cb) {
+    if (!begin(slot, waypoints, n, step, stepMs, cb)) return false;
+    Motion& m = slots[slot];
+    m.kind = MOTION_SERVO;
+    m.servo = &servo;
+    apply(m);
+    return true;
+}
+
+void MotionEngine::cancel(uint8_t slot) {
+    if (slot < MOTION_MAX_SLOTS) slots[slot].kind = MOTION_IDLE;
+}
+
+bool MotionEngine::active(uint8_t slot) const {
+    return slot < MOTION_MAX_SLOTS && slots[slot].kind != MOTION_IDLE;
+}
+
+int16_t MotionEngine::position(uint8_t slot) const {
+    return slot < MOTION_MAX_SLOTS ? slots[slot].position : 0;
+}
+
+void MotionEngine::apply(Motion& m) {
+    if (m.kind == MOTION_SERVO && m.servo) m.servo->write(m.position);
+}
+
+void MotionEngine::update(uint32_t nowMs) {
+    for (uint8_t i = 0; i < MOTION_MAX_SLOTS; i++) {
+        Motion& m = slots[i];
+        if (m.kind == MOTION_IDLE) continue;
+
+        uint32_t due = (nowMs - m.lastStep) / m.stepMs;
+        if (due == 0) continue;
+        m.lastStep += due * m.stepMs;
+
+        // Catch up on missed steps but write the actuator only once
+        bool finished = false;
+        while (due-- > 0 && !finished) {
+            int16_t goal = m.waypoints[m.target];
+            if (m.position < goal) {
+                m.position = min<int16_t>(m.position + m.stepSize, goal);
+            } else if (m.position > goal) {
+                m.position = max<int16_t>(m.position - m.stepSize, goal);
+            }
+            m.stepsDone++;
+            if (m.position == goal && ++m.target >= m.numWaypoints) finished = true;
+        }
+        apply(m);
+
+        MotionCallback cb = m.cb;
+        if (finished) {
+            m.kind = MOTION_IDLE;   // before cb, so it may chain a new motion here
+            if (cb) cb(i, 100, true);
+            continue;
+        }
+
+        uint8_t percent = m.stepsTotal ? (uint32_t)m.stepsDone * 100 / m.stepsTotal : 100;
+        if (percent >= 100) percent = 99;
+        if (cb && percent / MOTION_REPORT_PERCENT > m.lastReported / MOTION_REPORT_PERCENT) {
+            m.lastReported = percent;
+            cb(i, percent, false);
+        }
+    }
+}
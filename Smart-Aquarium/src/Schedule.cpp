@@ -0,0 +1,225 @@
+#include "Schedule.h"
+
+// 2000-01-01 was a Saturday
+static uint8_t dayOfWeek(uint32_t minute) {
+    return (minute / MINUTES_PER_DAY + 6) % 7;
+}
+
+// "HH:MM" -> minute of day
+static bool parseClock(const char*& p, const char* end, uint16_t& out) {
+    if (end - p < 5) return false;
+    if (!isdigit(p[0]) || !isdigit(p[1]) || p[2] != ':' || !isdigit(p[3]) || !isdigit(p[4])) return false;
+    uint8_t h = (p[0] - '0') * 10 + (p[1] - '0');
+    uint8_t m = (p[3] - '0') * 10 + (p[4] - '0');
+    if (h > 23 || m > 59) return false;
+    out = h * 60 + m;
+    p += 5;
+    return true;
+}
+
+ScheduleEngine::ScheduleEngine() : lastPoll(0) {
+    for (uint8_t d = 0; d < SCHED_MAX_DEVICES; d++) {
+        counts[d] = 0;
+        edge[d] = false;
+        lastEdge[d] = SCHED_NEVER;
+        heap[d].at = 0;        // everything is due on the first poll
+        heap[d].device = d;
+    }
+}
+
+bool ScheduleEngine::setWindow(uint8_t device, uint8_t index, uint16_t start, uint16_t end, uint8_t days) {
+    if (device >= SCHED_MAX_DEVICES || index >= SCHED_MAX_WINDOWS || index > counts[device]) return false;
+    if (start >= MINUTES_PER_DAY || end >= MINUTES_PER_DAY) return false;
+
+    windows[device][index] = { start, end, (uint8_t)(days & SCHED_ALL_DAYS) };
+    if (index == counts[device]) counts[device]++;
+    invalidate(device);
+    return true;
+}
+
+void ScheduleEngine::clear(uint8_t device) {
+    if (device >= SCHED_MAX_DEVICES) return;
+    counts[device] = 0;
+    invalidate(device);
+}
+
+uint8_t ScheduleEngine::windowCount(uint8_t device) const {
+    return device < SCHED_MAX_DEVICES ? counts[device] : 0;
+}
+
+const ScheduleWindow& ScheduleEngine::window(uint8_t device, uint8_t index) const {
+    return windows[device][index];
+}
+
+int ScheduleEngine::parse(uint8_t device, const char* text) {
+    return parse(device, text, strlen(text));
+}
+
+int ScheduleEngine::parse(uint8_t device, const char* text, size_t len) {
+    if (device >= SCHED_MAX_DEVICES) return -1;
+
+    ScheduleWindow parsed[SCHED_MAX_WINDOWS];
+    uint8_t n = 0;
+    const char* p = text;
+    const char* end = text + len;
+    while (p < end) {
+        if (n == SCHED_MAX_WINDOWS) return -1;
+        ScheduleWindow& w = parsed[n];
+        if (!parseClock(p, end, w.start) || p == end || *p++ != '-' || !parseClock(p, end, w.end)) return -1;
+        w.days = SCHED_ALL_DAYS;
+        if (p < end && *p == '@') {
+            uint8_t mask = 0, digits = 0;
+            for (p++; p < end && isxdigit(*p) && digits < 2; p++, digits++) {
+                mask = mask * 16 + (isdigit(*p) ? *p - '0' : (toupper(*p) - 'A' + 10));
+            }
+            if (digits == 0) return -1;
+            w.days = mask & SCHED_ALL_DAYS;
+        }
+        n++;
+        if (p < end && *p == ',') p++;
+        else if (p < end) return -1;
+    }
+
+    // Only replace the table once the whole string parsed
+    for (uint8_t i = 0; i < n; i++) windows[device][i] = parsed[i];
+    counts[device] = n;
+    invalidate(device);
+    return n;
+}
+
+size_t ScheduleEngine::format(uint8_t device, char* buf, size_t len) const {
+    size_t used = 0;
+    if (len == 0) return 0;
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < windowCount(device) && used < len; i++) {
+        const ScheduleWindow& w = windows[device][i];
+        used += snprintf(buf + used, len - used, "%s%02u:%02u-%02u:%02u", i ? "," : "",
+                         w.start / 60, w.start % 60, w.end / 60, w.end % 60);
+        if (w.days != SCHED_ALL_DAYS && used < len) {
+            used += snprintf(buf + used, len - used, "@%02X", w.days);
+        }
+    }
+    return used < len ? used : len - 1;
+}
+
+bool ScheduleEngine::isOn(uint8_t device, uint32_t minute) const {
+    uint16_t mod = minute % MINUTES_PER_DAY;
+    uint8_t today = 1 << dayOfWeek(minute);
+    uint8_t yesterday = (today == 1) ? 0x40 : (today >> 1);
+
+    for (uint8_t i = 0; i < counts[device]; i++) {
+        const ScheduleWindow& w = windows[device][i];
+        if (w.start == w.end) continue;
+        if (w.start < w.end) {
+            if ((w.days & today) && mod >= w.start && mod < w.end) return true;
+        } else {
+            // Overnight: the tail after midnight belongs to the previous day
+            if ((w.days & today) && mod >= w.start) return true;
+            if ((w.days & yesterday) && mod < w.end) return true;
+        }
+    }
+    return false;
+}
+
+// The first boundary after `minute` whose state differs from the current
+// one. State is constant between boundaries, so that is the next transition.
+uint32_t ScheduleEngine::computeNext(uint8_t device, uint32_t minute) const {
+    if (counts[device] == 0) return SCHED_NEVER;
+
+    bool state = isOn(device, minute);
+    uint32_t today = minute - minute % MINUTES_PER_DAY;
+    uint32_t best = SCHED_NEVER;
+
+    for (int8_t d = -1; d <= 7; d++) {
+        if (d < 0 && today < MINUTES_PER_DAY) continue;
+        uint32_t base = today + d * (int32_t)MINUTES_PER_DAY;
+        for (uint8_t i = 0; i < counts[device]; i++) {
+            const ScheduleWindow& w = windows[device][i];
+            uint32_t edges[2] = {
+                base + w.start,
+                base + w.end + (w.end < w.start ? MINUTES_PER_DAY : 0)
+            };
+            for (uint8_t e = 0; e < 2; e++) {
+                uint32_t c = edges[e];
+                if (c > minute && c < best && isOn(device, c) != state) best = c;
+            }
+        }
+    }
+    return best;
+}
+
+int8_t ScheduleEngine::find(uint8_t device) const {
+    for (uint8_t i = 0; i < SCHED_MAX_DEVICES; i++) {
+        if (heap[i].device == device) return i;
+    }
+    return -1;
+}
+
+void ScheduleEngine::siftUp(uint8_t i) {
+    while (i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if (heap[parent].at <= heap[i].at) break;
+        Entry tmp = heap[parent]; heap[parent] = heap[i]; heap[i] = tmp;
+        i = parent;
+    }
+}
+
+void ScheduleEngine::siftDown(uint8_t i) {
+    for (;;) {
+        uint8_t smallest = i;
+        uint8_t l = 2 * i + 1, r = 2 * i + 2;
+        if (l < SCHED_MAX_DEVICES && heap[l].at < heap[smallest].at) smallest = l;
+        if (r < SCHED_MAX_DEVICES && heap[r].at < heap[smallest].at) smallest = r;
+        if (smallest == i) break;
+        Entry tmp = heap[smallest]; heap[smallest] = heap[i]; heap[i] = tmp;
+        i = smallest;
+    }
+}
+
+void ScheduleEngine::setEntry(uint8_t device, uint32_t at) {
+    int8_t i = find(device);
+    if (i < 0) return;
+    uint32_t old = heap[i].at;
+    heap[i].at = at;
+    if (at < old) siftUp(i);
+    else siftDown(i);
+}
+
+void ScheduleEngine::invalidate(uint8_t device) {
+    setEntry(device, 0);
+}
+
+void ScheduleEngine::setEdge(uint8_t device, bool on) {
+    if (device < SCHED_MAX_DEVICES) edge[device] = on;
+}
+
+uint32_t ScheduleEngine::nextTransition(uint8_t device) const {
+    int8_t i = find(device);
+    return i < 0 ? SCHED_NEVER : heap[i].at;
+}
+
+void ScheduleEngine::poll(uint32_t minute, ScheduleHandler handler) {
+    // Clock stepped backwards (RTC/NTP correction): re-evaluate the level
+    // devices; edge devices just look for their next window start, which
+    // lastEdge keeps from being reported twice
+    if (minute < lastPoll) {
+        for (uint8_t d = 0; d < SCHED_MAX_DEVICES; d++) {
+            setEntry(d, edge[d] ? computeNext(d, minute) : 0);
+        }
+    }
+    lastPoll = minute;
+
+    while (heap[0].at <= minute) {
+        uint8_t device = heap[0].device;
+        uint32_t at = heap[0].at;
+        heap[0].at = computeNext(device, minute);
+        siftDown(0);
+        if (!edge[device]) {
+            if (handler) handler(device, isOn(device, minute));
+        } else if (at != 0 && at != lastEdge[device] && isOn(device, at)) {
+            // A real window start (0 is a re-evaluation), even if polled late
+            lastEdge[device] = at;
+            if (handler) handler(device, true);
+        }
+    }
+}
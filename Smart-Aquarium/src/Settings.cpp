@@ -0,0 +1,62 @@
+#include "Settings.h"
+
+SettingsStore::SettingsStore(uint32_t debounceMs, uint32_t maxDelayMs)
+    : debounceMs(debounceMs), maxDelayMs(maxDelayMs), opened(false), dirty(false),
+      firstDirtyAt(0), lastDirtyAt(0), counters() {
+    memset(&current, 0, sizeof(current));
+    memset(&stored, 0, sizeof(stored));
+}
+
+bool SettingsStore::begin(AquariumSettings& out) {
+    opened = prefs.begin(SETTINGS_NAMESPACE, false);
+    if (!opened) return false;
+
+    AquariumSettings s;
+    if (prefs.getBytesLength(SETTINGS_KEY) != sizeof(s)) return false;
+    if (prefs.getBytes(SETTINGS_KEY, &s, sizeof(s)) != sizeof(s)) return false;
+    if (s.version != SETTINGS_VERSION) return false;
+    for (uint8_t d = 0; d < SCHED_MAX_DEVICES; d++) {
+        if (s.counts[d] > SCHED_MAX_WINDOWS) return false;
+    }
+
+    memcpy(&current, &s, sizeof(s));
+    memcpy(&stored, &s, sizeof(s));
+    memcpy(&out, &s, sizeof(s));
+    return true;
+}
+
+// Compared bytewise, so callers should start from a zeroed struct
+void SettingsStore::save(const AquariumSettings& s) {
+    AquariumSettings next;
+    memcpy(&next, &s, sizeof(next));
+    next.version = SETTINGS_VERSION;
+    if (memcmp(&next, &current, sizeof(next)) == 0) return;
+
+    memcpy(&current, &next, sizeof(next));
+    uint32_t now = millis();
+    if (!dirty) firstDirtyAt = now;
+    lastDirtyAt = now;
+    dirty = true;
+    counters.saves++;
+}
+
+void SettingsStore::update(uint32_t nowMs) {
+    if (!dirty) return;
+    if (nowMs - lastDirtyAt < debounceMs && nowMs - firstDirtyAt < maxDelayMs) return;
+    flush();
+}
+
+void SettingsStore::flush() {
+    if (!dirty || !opened) return;
+    dirty = false;
+
+    // Edits that cancelled out (toggled and back) cost nothing
+    if (memcmp(&current, &stored, sizeof(current)) == 0) {
+        counters.skipped++;
+        return;
+    }
+    if (prefs.putBytes(SETTINGS_KEY, &current, sizeof(current)) == sizeof(current)) {
+        memcpy(&stored, &current, sizeof(current));
+        counters.writes++;
+    }
+}
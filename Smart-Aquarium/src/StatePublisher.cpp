@@ -0,0 +1,70 @@
+#include "StatePublisher.h"
+
+struct StateFieldInfo {
+    const char* key;       // JSON key inside the snapshot
+    const char* topic;     // legacy per-topic message
+    const char* initial;
+};
+
+static const StateFieldInfo fields[STATE_FIELD_COUNT] = {
+    { "pump",            "aquarium/state/pump",             "OFF" },
+    { "heater",          "aquarium/state/heater",           "OFF" },
+    { "led",             "aquarium/state/led",              "OFF" },
+    { "feed",            "aquarium/state/feed",             "IDLE" },
+    { "led_progress",    "aquarium/state/led/progress",     "0" },
+    { "feed_progress",   "aquarium/state/feed/progress",    "0" },
+    { "schedule_pump",   "aquarium/state/schedule/pump",    "" },
+    { "schedule_heater", "aquarium/state/schedule/heater",  "" },
+    { "schedule_led",    "aquarium/state/schedule/led",     "" },
+};
+
+StatePublisher::StatePublisher(PubSubClient& client, uint16_t windowMs, bool perTopic)
+    : client(client), windowMs(windowMs), perTopic(perTopic), dirty(0), firstDirtyAt(0), counters() {
+    for (uint8_t i = 0; i < STATE_FIELD_COUNT; i++) {
+        strlcpy(values[i], fields[i].initial, STATE_VALUE_LEN);
+    }
+}
+
+void StatePublisher::set(StateField field, const char* value) {
+    if (field >= STATE_FIELD_COUNT) return;
+    strlcpy(values[field], value, STATE_VALUE_LEN);
+    if (!dirty) firstDirtyAt = millis();
+    dirty |= 1 << field;
+    counters.changes++;
+}
+
+void StatePublisher::update(uint32_t nowMs) {
+    if (!dirty || nowMs - firstDirtyAt < windowMs) return;
+    if (!client.connected()) return;   // keep accumulating until the broker is back
+    flush();
+}
+
+size_t StatePublisher::buildSnapshot(char* buf, size_t len) const {
+    size_t used = snprintf(buf, len, "{");
+    for (uint8_t i = 0; i < STATE_FIELD_COUNT && used < len; i++) {
+        used += snprintf(buf + used, len - used, "%s\"%s\":\"%s\"",
+                         i ? "," : "", fields[i].key, values[i]);
+    }
+    if (used < len) used += snprintf(buf + used, len - used, ",\"saved\":%ld}", (long)counters.saved());
+    return used;
+}
+
+void StatePublisher::flush() {
+    if (!dirty) return;
+
+    if (perTopic) {
+        for (uint8_t i = 0; i < STATE_FIELD_COUNT; i++) {
+            if (dirty & (1 << i)) {
+                client.publish(fields[i].topic, values[i]);
+                counters.perTopic++;
+            }
+        }
+    }
+
+    static char snapshot[STATE_SNAPSHOT_LEN];
+    if (buildSnapshot(snapshot, sizeof(snapshot)) < sizeof(snapshot)) {
+        client.publish(STATE_TOPIC, snapshot, true);
+        counters.snapshots++;
+    }
+    dirty = 0;
+}
@@ -0,0 +1,71 @@
+#include "TimeService.h"
+#include <esp_timer.h>
+
+TimeService::TimeService(RtcDS1302<ThreeWire>& rtc, uint32_t resyncMs)
+    : rtc(rtc), resyncMs(resyncMs), baseSeconds(0), baseUs(0),
+      lastSync(0), lastNtpTry(0), ntpOk(false), correction(0), lock(portMUX_INITIALIZER_UNLOCKED) {}
+
+void TimeService::begin() {
+    syncFromRtc();
+    portENTER_CRITICAL(&lock);
+    correction = 0;
+    portEXIT_CRITICAL(&lock);
+}
+
+void TimeService::set(uint32_t seconds, bool writeRtc) {
+    int32_t step = (int32_t)(seconds - now());
+    int64_t us = esp_timer_get_time();
+    portENTER_CRITICAL(&lock);
+    correction = step;
+    baseSeconds = seconds;
+    baseUs = us;
+    portEXIT_CRITICAL(&lock);
+    lastSync = millis();
+    if (writeRtc) rtc.SetDateTime(RtcDateTime(seconds));
+}
+
+uint32_t TimeService::now() const {
+    portENTER_CRITICAL(&lock);
+    uint32_t seconds = baseSeconds;
+    int64_t us = baseUs;
+    portEXIT_CRITICAL(&lock);
+    return seconds + (uint32_t)((esp_timer_get_time() - us) / 1000000LL);
+}
+
+int32_t TimeService::lastCorrection() const {
+    portENTER_CRITICAL(&lock);
+    int32_t c = correction;
+    portEXIT_CRITICAL(&lock);
+    return c;
+}
+
+// Non-blocking: only succeeds once SNTP has already set the system clock.
+// getLocalTime() would delay(10) even with a 0 ms timeout.
+bool TimeService::syncFromNtp() {
+    time_t utc = time(nullptr);
+    if (utc < TIME_VALID_UNIX) return false;
+    struct tm timeinfo;
+    localtime_r(&utc, &timeinfo);
+
+    RtcDateTime ntp(timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+                    timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+    int32_t drift = (int32_t)(ntp.TotalSeconds() - now());
+    set(ntp.TotalSeconds(), abs(drift) > TIME_RTC_DRIFT_MAX || !ntpOk);
+    ntpOk = true;
+    return true;
+}
+
+void TimeService::syncFromRtc() {
+    set(rtc.GetDateTime().TotalSeconds(), false);
+}
+
+void TimeService::update() {
+    uint32_t ms = millis();
+    bool resyncDue = ms - lastSync >= resyncMs;
+    bool ntpRetryDue = !ntpOk && ms - lastNtpTry >= TIME_NTP_RETRY_MS;
+    if (!resyncDue && !ntpRetryDue) return;
+
+    lastNtpTry = ms;
+    if (syncFromNtp()) return;
+    if (resyncDue) syncFromRtc();   // offline: fall back to the RTC
+}
@@ -20,8 +20,21 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <PagedSSD1306.h>
 #include <RtcDS1302.h>
 
+#include "MotionEngine.h"
+#include "Schedule.h"
+#include "TimeService.h"
+#include "TopicDispatch.h"
+#include "StatePublisher.h"
+#include "Benchmarks.h"
+#include "Commands.h"
+#include "Settings.h"
+#include "SpscRing.h"
+#include <NetManager.h>
+#include <LedcFader.h>
+
 /************ WIFI & MQTT ************/
 const char* ssid = "23-1078";
 const char* password = "";
@@ -30,6 +43,8 @@ const int mqtt_port = 1883;
 
 WiFiClient espClient;
 PubSubClient client(espClient);
+StatePublisher statePub(client);   // snapshot only; setPerTopic(true) for legacy Node-RED flows
+NetManager net;
 
 /************ PINS ************/
 #define PUMP_RELAY   16
@@ -48,7 +63,33 @@ PubSubClient client(espClient);
 Servo feederServo;
 ThreeWire rtcWire(RTC_DAT, RTC_CLK, RTC_RST);
 RtcDS1302<ThreeWire> Rtc(rtcWire);
-Adafruit_SSD1306 display(128, 64, &Wire, -1);
+TimeService timeService(Rtc);
+PagedSSD1306 display(128, 64, &Wire, -1);
+MotionEngine motions;
+LedcFader fader;
+ScheduleEngine schedule;
+SettingsStore settings;
+
+// Core 0 (network) <-> core 1 (control)
+SpscRing<Command, 16> commandQueue;    // network -> control
+SpscRing<StateEvent, 32> stateQueue;   // control -> network
+TaskHandle_t networkTaskHandle = NULL;
+TaskHandle_t displayTaskHandle = NULL;
+void networkTask(void* param);
+void displayTask(void* param);
+
+// Motion slots
+#define MOTION_FEEDER 0
+
+// Network links (registration order in setup())
+#define LINK_MQTT     0
+#define LINK_BLYNK    1
+
+// Schedule devices
+#define SCHED_PUMP    0
+#define SCHED_HEATER  1
+#define SCHED_LED     2
+#define SCHED_FEED    3
 
 /************ STATE VARIABLES ************/
 bool pumpState = false;
@@ -61,35 +102,68 @@ bool pumpOverride = false;
 bool heaterOverride = false;
 bool ledOverride = false;
 
-// Schedule Times (Start H, Start M, End H, End M)
+// Schedule windows live in `schedule`
 // V10: Pump, V11: Heater, V12: LED
-int pumpSH=0, pumpSM=0, pumpEH=0, pumpEM=0;
-int heaterSH=0, heaterSM=0, heaterEH=0, heaterEM=0;
-int ledSH=0, ledSM=0, ledEH=0, ledEM=0;
 
-// Feeding Schedule
+// Feeding Schedule (a one-minute window, fed on its rising edge)
 int feedH=8, feedM=0;
-bool feedDoneToday = false;
 
 // LED PWM
 const int freq = 5000;
 const int ledChannel = 0;
 const int resolution = 8;
+#define LED_FADE_MS    510   // full 0..255 swing, in hardware
+#define LED_FADE_PARTS 4     // progress reported every 25%
 
 /************ HARDWARE CONTROL ************/
+// Everything in this section runs in the control task (core 1)
+
+// Queues a state change for MQTT (and optionally Blynk) on the network core
+void report(StateField field, const char* value, int8_t blynkPin = BLYNK_PIN_NONE, int8_t blynkValue = 0) {
+    StateEvent ev;
+    ev.field = field;
+    ev.blynkPin = blynkPin;
+    ev.blynkValue = blynkValue;
+    strlcpy(ev.value, value, sizeof(ev.value));
+    stateQueue.push(ev);
+}
+
+// LED fade progress / completion, drained from the fader in loop()
+void onLedFade(const FadeEvent& ev) {
+    uint8_t percent = ev.done ? 100 : (ev.ramp + 1) * 100 / ev.count;
+    char buf[4];
+    snprintf(buf, sizeof(buf), "%u", percent);
+    report(STATE_LED_PROGRESS, buf);
+
+    // duty 0: not the tail of a fade-in that was reversed since
+    if (ev.done && !ledState && ev.duty == 0) {
+        ledcWrite(ledChannel, 0); // Ensure fully OFF
+        ledcDetachPin(LED_PIN);   // Detach PWM
+        digitalWrite(LED_PIN, LOW); // Hard pull-down
+    }
+}
 
-// Updates Hardware + MQTT + Blynk
+// Motion progress / completion (feeder sweep)
+void onMotion(uint8_t slot, uint8_t percent, bool done) {
+    char buf[4];
+    snprintf(buf, sizeof(buf), "%u", percent);
+
+    if (slot == MOTION_FEEDER) {
+        report(STATE_FEED_PROGRESS, buf);
+        if (done) {
+            feederServo.detach();
+            feedingNow = false;
+            report(STATE_FEED, "IDLE", V3, 0);
+        }
+    }
+}
+
+// Updates Hardware, then reports to MQTT + Blynk
 void setPump(bool on, bool fromBlynk = false) {
     if (pumpState != on) {
         pumpState = on;
         digitalWrite(PUMP_RELAY, on ? LOW : HIGH); // Active LOW
-        
-        const char* pay = on ? "ON" : "OFF";
-        client.publish("aquarium/state/pump", pay);
-        
-        if (!fromBlynk) {
-            Blynk.virtualWrite(V0, on ? 1 : 0);
-        }
+        report(STATE_PUMP, on ? "ON" : "OFF", fromBlynk ? BLYNK_PIN_NONE : V0, on);
     }
 }
 
@@ -97,49 +171,24 @@ void setHeater(bool on, bool fromBlynk = false) {
     if (heaterState != on) {
         heaterState = on;
         digitalWrite(HEATER_RELAY, on ? LOW : HIGH); // Active LOW
-        
-        const char* pay = on ? "ON" : "OFF";
-        client.publish("aquarium/state/heater", pay);
-        
-        if (!fromBlynk) {
-            Blynk.virtualWrite(V1, on ? 1 : 0);
-        }
+        report(STATE_HEATER, on ? "ON" : "OFF", fromBlynk ? BLYNK_PIN_NONE : V1, on);
     }
 }
 
-// PWM Fade Wrapper
+// PWM Fade Wrapper (LEDC hardware fade, no CPU between the 25% steps)
 void ledFade(bool fadeIn) {
     if (fadeIn) {
         ledcAttachPin(LED_PIN, ledChannel); // Attach before fading in
-        // Fade 0 -> 255
-        for (int i = 0; i <= 255; i += 5) {
-            ledcWrite(ledChannel, i);
-            delay(10);
-        }
-    } else {
-        // Fade 255 -> 0
-        for (int i = 255; i >= 0; i -= 5) {
-            ledcWrite(ledChannel, i);
-            delay(10);
-        }
-        ledcWrite(ledChannel, 0); // Ensure fully OFF
-        ledcDetachPin(LED_PIN);   // Detach PWM
-        digitalWrite(LED_PIN, LOW); // Hard pull-down
     }
+    // Reverses from wherever a running fade is once its current part ends
+    fader.fadeTo(ledChannel, fadeIn ? 255 : 0, LED_FADE_MS, LED_FADE_PARTS);
 }
 
 void setLED(bool on, bool fromBlynk = false) {
     if (ledState != on) {
         ledState = on;
-        
         ledFade(on);
-        
-        const char* pay = on ? "ON" : "OFF";
-        client.publish("aquarium/state/led", pay);
-        
-        if (!fromBlynk) {
-             Blynk.virtualWrite(V2, on ? 1 : 0);
-        }
+        report(STATE_LED, on ? "ON" : "OFF", fromBlynk ? BLYNK_PIN_NONE : V2, on);
     }
 }
 
@@ -147,132 +196,213 @@ void feedFish() {
     if (feedingNow) return;
     feedingNow = true;
     
-    client.publish("aquarium/state/feed", "RUNNING");
-    Blynk.virtualWrite(V3, 1);
-    
-
+    report(STATE_FEED, "RUNNING", V3, 1);
     
+    // Rotate 0 to 180 and back, finished in onMotion()
+    static const int16_t sweep[] = { 0, 180, 0 };
     feederServo.attach(SERVO_PIN);
-    
-    // Rotate 0 to 180
-    for(int i=0; i<=180; i+=2){ 
-        feederServo.write(i); 
-        delay(10); 
+    motions.startServo(MOTION_FEEDER, feederServo, sweep, 3, 2, 10, onMotion);
+}
+
+/************ SCHEDULE ************/
+void reportSchedule(uint8_t device) {
+    static const StateField fields[] = { STATE_SCHEDULE_PUMP, STATE_SCHEDULE_HEATER, STATE_SCHEDULE_LED };
+    char buf[STATE_VALUE_LEN];
+    schedule.format(device, buf, sizeof(buf));
+    report(fields[device], buf);
+}
+
+// Runs only when a device's window boundary is reached (or it was invalidated)
+void onSchedule(uint8_t device, bool on) {
+    switch (device) {
+        case SCHED_PUMP:   if (!pumpOverride)   setPump(on);   break;
+        case SCHED_HEATER: if (!heaterOverride) setHeater(on); break;
+        case SCHED_LED:    if (!ledOverride)    setLED(on);    break;
+        case SCHED_FEED:   if (on) feedFish();                 break;
     }
-    
-    // Rotate 180 to 0
-    for(int i=180; i>=0; i-=2){ 
-        feederServo.write(i); 
-        delay(10); 
+}
+
+/************ PERSISTENCE ************/
+// Schedules (incl. feed time) and overrides survive a reboot via NVS
+void saveSettings() {
+    AquariumSettings s;
+    memset(&s, 0, sizeof(s));   // compared bytewise: keep padding zero
+    for (uint8_t d = 0; d < SCHED_MAX_DEVICES; d++) {
+        s.counts[d] = schedule.windowCount(d);
+        for (uint8_t i = 0; i < s.counts[d]; i++) {
+            const ScheduleWindow& w = schedule.window(d, i);
+            s.windows[d][i].start = w.start;
+            s.windows[d][i].end = w.end;
+            s.windows[d][i].days = w.days;
+        }
     }
-    
-    feederServo.detach();
-    
-    feedingNow = false;
-    client.publish("aquarium/state/feed", "IDLE");
-    Blynk.virtualWrite(V3, 0); 
+    // Manual state is only kept while overridden, so schedule-driven
+    // switching never causes a flash write
+    if (pumpOverride)   { s.overrides |= 1 << SCHED_PUMP;   if (pumpState)   s.manual |= 1 << SCHED_PUMP; }
+    if (heaterOverride) { s.overrides |= 1 << SCHED_HEATER; if (heaterState) s.manual |= 1 << SCHED_HEATER; }
+    if (ledOverride)    { s.overrides |= 1 << SCHED_LED;    if (ledState)    s.manual |= 1 << SCHED_LED; }
+    settings.save(s);
+}
+
+// Runs in setup() before networking, so the tank is back on its own
+// schedule (or manual state) immediately after a reboot
+bool restoreSettings() {
+    AquariumSettings s;
+    if (!settings.begin(s)) return false;
+
+    for (uint8_t d = 0; d < SCHED_MAX_DEVICES; d++) {
+        schedule.clear(d);
+        for (uint8_t i = 0; i < s.counts[d]; i++) {
+            const ScheduleWindow& w = s.windows[d][i];
+            schedule.setWindow(d, i, w.start, w.end, w.days);
+        }
+    }
+    pumpOverride = s.overrides & (1 << SCHED_PUMP);
+    heaterOverride = s.overrides & (1 << SCHED_HEATER);
+    ledOverride = s.overrides & (1 << SCHED_LED);
+    if (pumpOverride)   setPump(s.manual & (1 << SCHED_PUMP));
+    if (heaterOverride) setHeater(s.manual & (1 << SCHED_HEATER));
+    if (ledOverride)    setLED(s.manual & (1 << SCHED_LED));
+    for (uint8_t d = SCHED_PUMP; d <= SCHED_LED; d++) reportSchedule(d);
+    return true;
+}
+
+// Applies one command from the network core
+void applyCommand(const Command& cmd) {
+    switch (cmd.type) {
+        case CMD_PUMP:
+            pumpOverride = true;
+            setPump(cmd.on, cmd.fromBlynk);
+            break;
+        case CMD_HEATER:
+            heaterOverride = true;
+            setHeater(cmd.on, cmd.fromBlynk);
+            break;
+        case CMD_LED:
+            ledOverride = true;
+            setLED(cmd.on, cmd.fromBlynk);
+            break;
+        case CMD_FEED:
+            feedFish();
+            break;
+        case CMD_OVERRIDE_RESET:
+            pumpOverride = false;
+            heaterOverride = false;
+            ledOverride = false;
+            schedule.invalidate(SCHED_PUMP);
+            schedule.invalidate(SCHED_HEATER);
+            schedule.invalidate(SCHED_LED);
+            break;
+        // Multi-window schedules: "HH:MM-HH:MM[@mask],..."
+        case CMD_SCHEDULE_PUMP:
+            if (schedule.parse(SCHED_PUMP, cmd.text) >= 0) pumpOverride = false;
+            reportSchedule(SCHED_PUMP);
+            break;
+        case CMD_SCHEDULE_HEATER:
+            if (schedule.parse(SCHED_HEATER, cmd.text) >= 0) heaterOverride = false;
+            reportSchedule(SCHED_HEATER);
+            break;
+        case CMD_SCHEDULE_LED:
+            if (schedule.parse(SCHED_LED, cmd.text) >= 0) ledOverride = false;
+            reportSchedule(SCHED_LED);
+            break;
+        default:
+            break;
+    }
+    saveSettings();   // no-op unless something persistent changed
+}
+
+/************ COMMAND INPUT ************/
+// Blynk handlers and the MQTT callback run on the network core and only
+// enqueue commands; they never touch the actuators directly.
+
+void sendCommand(AquariumCommand type, bool on = false, bool fromBlynk = false,
+                 const char* text = "", size_t len = 0) {
+    Command cmd;
+    cmd.type = type;
+    cmd.on = on;
+    cmd.fromBlynk = fromBlynk;
+    len = min(len, sizeof(cmd.text) - 1);
+    memcpy(cmd.text, text, len);
+    cmd.text[len] = '\0';
+    commandQueue.push(cmd);
 }
 
-/************ BLYNK HANDLERS ************/
 // V0: Pump Switch
 BLYNK_WRITE(V0) {
-    bool val = param.asInt();
-    pumpOverride = true;
-    setPump(val, true);
+    sendCommand(CMD_PUMP, param.asInt(), true);
 }
 // V1: Heater Switch
 BLYNK_WRITE(V1) {
-    bool val = param.asInt();
-    heaterOverride = true;
-    setHeater(val, true);
+    sendCommand(CMD_HEATER, param.asInt(), true);
 }
 // V2: LED Switch
 BLYNK_WRITE(V2) {
-    bool val = param.asInt();
-    ledOverride = true;
-    setLED(val, true);
+    sendCommand(CMD_LED, param.asInt(), true);
 }
 // V3: Feed Button
 BLYNK_WRITE(V3) {
     if(param.asInt() == 1) {
-        feedFish();
+        sendCommand(CMD_FEED);
     }
 }
 
-// Time Input Widgets parsing: Start(sec), Stop(sec), TZ...
-// We just need Start/Stop
-void parseTimeInput(const BlynkParam& param, int &sh, int &sm, int &eh, int &em) {
-    long start = param[0].asLong();
-    long stop = param[1].asLong();
-    
+// Time Input Widgets parsing: Start(sec), Stop(sec), TZ, Days...
+// Turned into the single-window schedule text "HH:MM-HH:MM@mask"
+void sendTimeInput(const BlynkParam& param, AquariumCommand type) {
+    long start = (param[0].asLong() / 60) % MINUTES_PER_DAY;
+    long stop = (param[1].asLong() / 60) % MINUTES_PER_DAY;
+
+    // Optional weekday list "1,2,..." with Monday = 1 ... Sunday = 7
+    uint8_t days = SCHED_ALL_DAYS;
+    BlynkParam::iterator wd = param[3];
+    if (wd.isValid() && !wd.isEmpty()) {
+        days = 0;
+        for (const char* p = wd.asStr(); *p; p++) {
+            if (*p >= '1' && *p <= '7') days |= 1 << ((*p - '0') % 7);
+        }
+    }
+
     // TimeInput sends seconds from midnight
-    sh = (start / 3600) % 24;
-    sm = (start / 60) % 60;
-    eh = (stop / 3600) % 24;
-    em = (stop / 60) % 60;
+    char text[24];
+    int len = snprintf(text, sizeof(text), "%02ld:%02ld-%02ld:%02ld@%02X",
+                       start / 60, start % 60, stop / 60, stop % 60, days);
+    sendCommand(type, false, true, text, len);
 }
 
 BLYNK_WRITE(V10) { // Pump Schedule
-    parseTimeInput(param, pumpSH, pumpSM, pumpEH, pumpEM);
-    pumpOverride = false;
-    // Also publish to MQTT for Node-RED visibility?
-    char buf[20];
-    sprintf(buf, "%02d:%02d-%02d:%02d", pumpSH, pumpSM, pumpEH, pumpEM);
-    client.publish("aquarium/state/schedule/pump", buf);
+    sendTimeInput(param, CMD_SCHEDULE_PUMP);
 }
 
 BLYNK_WRITE(V11) { // Heater Schedule
-    parseTimeInput(param, heaterSH, heaterSM, heaterEH, heaterEM);
-    heaterOverride = false;
-    char buf[20];
-    sprintf(buf, "%02d:%02d-%02d:%02d", heaterSH, heaterSM, heaterEH, heaterEM);
-    client.publish("aquarium/state/schedule/heater", buf);
+    sendTimeInput(param, CMD_SCHEDULE_HEATER);
 }
 
 BLYNK_WRITE(V12) { // LED Schedule
-    parseTimeInput(param, ledSH, ledSM, ledEH, ledEM);
-    ledOverride = false;
-    char buf[20];
-    sprintf(buf, "%02d:%02d-%02d:%02d", ledSH, ledSM, ledEH, ledEM);
-    client.publish("aquarium/state/schedule/led", buf);
+    sendTimeInput(param, CMD_SCHEDULE_LED);
 }
 
-
 /************ MQTT CALLBACK ************/
+// Decoded in place from PubSubClient's buffer: no String, no heap
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-    String msg;
-    for (int i = 0; i < length; i++) msg += (char)payload[i];
-    String t = String(topic);
-
-    if (t == "aquarium/set/pump") {
-        pumpOverride = true;
-        setPump(msg == "ON", false);
-    } 
-    else if (t == "aquarium/set/heater") {
-        heaterOverride = true;
-        setHeater(msg == "ON", false);
-    }
-    else if (t == "aquarium/set/led") {
-        ledOverride = true;
-        setLED(msg == "ON", false);
-    }
-    else if (t == "aquarium/set/feed") {
-        feedFish();
-    }
-    else if (t == "aquarium/set/override/reset") {
-        pumpOverride = false;
-        heaterOverride = false;
-        ledOverride = false;
-    }
+    AquariumCommand type = decodeTopic(topic);
+    if (type == CMD_NONE) return;
+    sendCommand(type, payloadIs(payload, length, "ON"), false, (const char*)payload, length);
 }
 
-void reconnectMqtt() {
-    if (!client.connected()) {
-        if (client.connect("ESP32Aquarium")) {
-            client.subscribe("aquarium/set/#");
-        }
-    }
+/************ CONNECTIVITY ************/
+// Link callbacks for `net`; each attempt is a single short try
+bool mqttAttempt() {
+    if (!client.connect("ESP32Aquarium")) return false;
+    client.subscribe("aquarium/set/#");
+    return true;
 }
+bool mqttConnected() { return client.connected(); }
+void mqttService()   { client.loop(); }
+
+bool blynkAttempt()   { Blynk.run(); return Blynk.connected(); }
+bool blynkConnected() { return Blynk.connected(); }
+void blynkService()   { Blynk.run(); }
 
 /************ SETUP ************/
 void setup() {
@@ -289,6 +419,8 @@ void setup() {
     digitalWrite(LED_PIN, LOW);
     
     ledcSetup(ledChannel, freq, resolution);
+    fader.begin();
+    fader.attach(ledChannel, resolution);
 
     feederServo.attach(SERVO_PIN);
     feederServo.write(0);
@@ -304,82 +436,123 @@ void setup() {
     display.println("Booting...");
     display.display();
 
-    // Init RTC
-    Rtc.Begin();
+#ifdef AQUARIUM_BENCH
+    runBenchmarks();
+#endif
 
-    // Connect WiFi
-    
-    WiFi.begin(ssid, password);
-    int wifiCount = 0;
-    while (WiFi.status() != WL_CONNECTED && wifiCount < 20) {
-        delay(500);
-        Serial.print(".");
-        wifiCount++;
+    // Init RTC (read once, then tracked by timeService)
+    Rtc.Begin();
+    timeService.begin();
+
+    // Restore schedules/overrides and apply them before any networking.
+    // The feeder acts on window starts only, never on a re-evaluation.
+    schedule.setEdge(SCHED_FEED, true);
+    if (!restoreSettings()) {
+        uint16_t feedAt = feedH * 60 + feedM;
+        schedule.setWindow(SCHED_FEED, 0, feedAt, (feedAt + 1) % MINUTES_PER_DAY);
     }
+    schedule.poll(timeService.epochMinute(), onSchedule);
+
+    // Connect WiFi / MQTT / Blynk in the background (driven by net.loop())
+    net.begin(ssid, password);
+    net.addLink("MQTT", mqttAttempt, mqttConnected, mqttService);
+    net.addLink("Blynk", blynkAttempt, blynkConnected, blynkService);
 
     Blynk.config(BLYNK_AUTH_TOKEN);
     
-    // Sync Time
+    // Sync Time (timeService picks up the NTP time and writes the RTC)
     configTime(5 * 3600, 0, "pool.ntp.org", "time.nist.gov");
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo)) {
-        RtcDateTime now(timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday, timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-        Rtc.SetDateTime(now);
-    }
     
+    espClient.setTimeout(1);       // bound the TCP connect of each MQTT attempt
     client.setServer(mqtt_server, mqtt_port);
     client.setCallback(mqttCallback);
+    client.setBufferSize(STATE_SNAPSHOT_LEN + 64); // retained snapshot + header
+
+    // Networking + display on core 0; loop() keeps core 1 for control
+    xTaskCreatePinnedToCore(
+        networkTask,        // function
+        "Network Task",     // name
+        8192,               // stack size
+        NULL,               // param
+        1,                  // priority
+        &networkTaskHandle,
+        0                   // core
+    );
+
+    // Own task: a link attempt blocking the network task for its connect
+    // timeout must not freeze the OLED
+    xTaskCreatePinnedToCore(displayTask, "Display Task", 4096, NULL, 1, &displayTaskHandle, 0);
 }
 
-bool isTimeInRange(int h, int m, int sh, int sm, int eh, int em) {
-    int now = h * 60 + m;
-    int start = sh * 60 + sm;
-    int end = eh * 60 + em;
-    if (start == end) return false;
-    if (start < end) return now >= start && now < end;
-    return now >= start || now < end; 
-}
-
-/************ LOOP ************/
-void loop() {
-    Blynk.run();
-    
-    if (!client.connected()) reconnectMqtt();
-    client.loop();
-
-    RtcDateTime now = Rtc.GetDateTime();
-    int h = now.Hour();
-    int m = now.Minute();
-
-    // Automation
-    if (!pumpOverride) {
-        setPump(isTimeInRange(h, m, pumpSH, pumpSM, pumpEH, pumpEM));
-    }
-    if (!heaterOverride) {
-        setHeater(isTimeInRange(h, m, heaterSH, heaterSM, heaterEH, heaterEM));
-    }
-    if (!ledOverride) {
-        setLED(isTimeInRange(h, m, ledSH, ledSM, ledEH, ledEM));
-    }
-
-    // Feeding
-    if (h == feedH && m == feedM && !feedDoneToday) {
-        feedFish();
-        feedDoneToday = true;
+/************ NETWORK + DISPLAY TASKS (core 0) ************/
+// Blynk, MQTT and state publishing; the OLED in a task of its own. A slow
+// broker or I2C transfer here can never delay a relay switch on the
+// control core.
+void drainStateQueue() {
+    StateEvent ev;
+    while (stateQueue.pop(ev)) {
+        statePub.set(ev.field, ev.value);
+        if (ev.blynkPin != BLYNK_PIN_NONE) {
+            Blynk.virtualWrite(ev.blynkPin, ev.blynkValue);
+        }
     }
-    if (h == 0 && m == 0) feedDoneToday = false;
+}
 
-    // Display
+void updateDisplay() {
     static unsigned long lastOled = 0;
     if (millis() - lastOled > 1000) {
         lastOled = millis();
         display.clearDisplay();
         display.setCursor(0,0);
-        display.printf("Time: %02d:%02d\n", h, m);
+        display.printf("Time: %02d:%02d\n", timeService.hour(), timeService.minute());
         display.printf("Pump: %s %s\n", pumpState?"ON":"OFF", pumpOverride?"(M)":"");
         display.printf("Heat: %s %s\n", heaterState?"ON":"OFF", heaterOverride?"(M)":"");
         display.printf("Light: %s %s\n", ledState?"ON":"OFF", ledOverride?"(M)":"");
-        display.printf("Blynk: %s\n", Blynk.connected()?"OK":"DQ");
+        display.printf("Blynk: %s\n", NetManager::stateName(net.link(LINK_BLYNK).state));
+        display.printf("WiFi: %s MQTT: %s\n", NetManager::stateName(net.wifiStatus()),
+                       NetManager::stateName(net.link(LINK_MQTT).state));
         display.display();
     }
 }
+
+// One pass of the network task (also driven directly by the host simulator)
+void networkStep() {
+    net.loop();
+    drainStateQueue();
+    statePub.update(millis());
+}
+
+void networkTask(void*) {
+    for (;;) {
+        networkStep();
+        vTaskDelay(1);
+    }
+}
+
+// The only user of the display after setup()
+void displayTask(void*) {
+    for (;;) {
+        updateDisplay();
+        vTaskDelay(100 / portTICK_PERIOD_MS);
+    }
+}
+
+/************ LOOP (control, core 1) ************/
+void loop() {
+    Command cmd;
+    while (commandQueue.pop(cmd)) applyCommand(cmd);
+
+    motions.update(millis());
+
+    FadeEvent fade;
+    while (fader.read(fade)) onLedFade(fade);
+
+    timeService.update();
+
+    // Automation + Feeding (no-op until the next transition is due)
+    schedule.poll(timeService.epochMinute(), onSchedule);
+
+    settings.update(millis());
+
+    vTaskDelay(1);
+}
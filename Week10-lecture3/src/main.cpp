@@ -21,8 +21,11 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <PagedSSD1306.h>
 
-#include "DHT.h"
+#include <RmtDHT.h>
+#include <ButtonEvents.h>
+#include <SensorSources.h>
 
 // ------------ WiFi credentials (for wokwi) ------------
 char ssid[] = "23-1078";
@@ -39,30 +42,65 @@ char pass[] = "";
 #define SCREEN_HEIGHT 64
 #define OLED_RESET    -1  // no reset pin
 
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
-DHT dht(DHTPIN, DHTTYPE);
-
-BlynkTimer timer;
-
-// For simple button edge detection
-int lastButtonState = HIGH;
-
-// Forward declaration
-void readAndDisplayAndSend();
-
-// Optional: send periodically to Blynk (even without button)
-void periodicSend() {
-  readAndDisplayAndSend();
+PagedSSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+RmtDHT dht(DHTPIN, DHTTYPE);   // RMT capture, decoded in a background task
+
+// Button presses arrive debounced through a queue
+ButtonEvents buttons;
+
+// A button press within this age of the last sample is answered by it
+// (the DHT11 has nothing newer to give within ~1 s anyway)
+#define SAMPLE_FRESH_MS  1500
+
+// Unchanged readings are re-sent to Blynk only this often
+#define BLYNK_RESEND_MS  60000
+#define STATS_REPORT_MS  60000
+
+struct BlynkUplink {
+  float temp;
+  float hum;
+  uint32_t sentAt;
+  uint32_t updates;    // grouped V0+V1 writes
+  uint32_t skipped;    // samples equal to what Blynk already has
+};
+BlynkUplink uplink = { NAN, NAN, 0, 0, 0 };
+unsigned long lastReport = 0;
+
+// Map: V0 = Temp, V1 = Humidity, sent as one grouped update
+void sendToBlynk(const SensorFrame& f) {
+  if (f.temperature == uplink.temp && f.humidity == uplink.hum &&
+      f.timestamp - uplink.sentAt < BLYNK_RESEND_MS) {
+    uplink.skipped++;
+    return;
+  }
+  Blynk.beginGroup();
+  Blynk.virtualWrite(V0, f.temperature);
+  Blynk.virtualWrite(V1, f.humidity);
+  Blynk.endGroup();
+
+  uplink.temp = f.temperature;
+  uplink.hum = f.humidity;
+  uplink.sentAt = f.timestamp;
+  uplink.updates++;
 }
 
+// Node: DHT sample -> Serial + OLED, then (valid samples only) Blynk
+auto node = makePipeline(
+  dhtSource(dht),
+  printSink(Serial),
+  oledSink(display, "Environment Node", "BTN -> manual update"),
+  requireFields(FRAME_TEMP | FRAME_HUM),
+  callSink(sendToBlynk));
+
 void setup() {
   Serial.begin(115200);
   delay(1000);
   Serial.println();
   Serial.println("ESP32 DHT22 + OLED + Blynk starting...");
 
-  // Button input with internal pull-up
-  pinMode(BUTTON_PIN, INPUT_PULLUP);
+  // Button input with internal pull-up, interrupt driven
+  buttons.add(BUTTON_PIN);
+  buttons.begin();
 
   // I2C + OLED
   Wire.begin(21, 22);  // SDA, SCL (as per diagram)
@@ -77,69 +115,38 @@ void setup() {
   display.println("Booting...");
   display.display();
 
-  // DHT sensor
-  dht.begin();
+  // DHT sensor: sampled every second in the background
+  dht.begin(1000);
 
   // Blynk (for real hardware WiFi)
   Serial.println("Connecting to Blynk...");
   Blynk.begin(BLYNK_AUTH_TOKEN, ssid, pass);
   // For Wokwi, WiFi is simulated via wokwi.toml [net] config
-
-  // Periodic send every 5 seconds (optional)
-  timer.setInterval(1000L, periodicSend);
-}
-
-// Reads DHT22, updates OLED and sends to Blynk
-void readAndDisplayAndSend() {
-  float h = dht.readHumidity();
-  float t = dht.readTemperature(); // Celsius
-
-  if (isnan(h) || isnan(t)) {
-    Serial.println("Failed to read from DHT sensor!");
-    display.clearDisplay();
-    display.setCursor(0, 0);
-    display.println("DHT Error!");
-    display.display();
-    return;
-  }
-
-  Serial.print("Temp: ");
-  Serial.print(t);
-  Serial.print(" *C, Hum: ");
-  Serial.print(h);
-  Serial.println(" %");
-
-  // --- Update OLED ---
-  display.clearDisplay();
-  display.setCursor(0, 0);
-  display.println("Environment Node");
-  display.println("-----------------");
-  display.print("Temp: ");
-  display.print(t, 1);
-  display.println(" C");
-  display.print("Hum : ");
-  display.print(h, 1);
-  display.println(" %");
-  display.println();
-  display.println("BTN -> manual update");
-  display.display();
-
-  // --- Send to Blynk (Virtual Pins) ---
-  // Map: V0 = Temp, V1 = Humidity
-  Blynk.virtualWrite(V0, t);
-  Blynk.virtualWrite(V1, h);
 }
 
 void loop() {
   Blynk.run();
-  timer.run();
-
-  // Simple button edge detection (active LOW)
-  int currentState = digitalRead(BUTTON_PIN);
-  if (lastButtonState == HIGH && currentState == LOW) {
-    // Falling edge -> button pressed
-    Serial.println("Button pressed: manual DHT read");
-    readAndDisplayAndSend();
+
+  // Periodic and button-triggered samples both arrive here
+  node.step();
+
+  // A fresh sample is already on the OLED and in Blynk; otherwise one
+  // read is requested, however often pressed.
+  ButtonEvent e;
+  while (buttons.read(e)) {
+    if (e.type != BTN_PRESS) continue;
+    if (dht.request(SAMPLE_FRESH_MS)) {
+      Serial.println("Button pressed: latest sample is fresh");
+    } else {
+      Serial.println("Button pressed: manual DHT read");
+    }
+  }
+
+  if (millis() - lastReport >= STATS_REPORT_MS) {
+    lastReport = millis();
+    Serial.printf("DHT: %lu reads, %lu cached, %lu coalesced | Blynk: %lu updates, %lu skipped\n",
+                  (unsigned long)dht.reads(), (unsigned long)dht.cacheHits(),
+                  (unsigned long)dht.coalesced(), (unsigned long)uplink.updates,
+                  (unsigned long)uplink.skipped);
   }
-  lastButtonState = currentState;
 }
\ No newline at end of file
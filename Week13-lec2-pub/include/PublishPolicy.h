@@ -0,0 +1,105 @@
+// Publishing policies for the DHT publisher
+//   PUB_FIXED     every sample as two text messages (the original behaviour)
+//   PUB_DEADBAND  a metric is only sent when it moved by more than its
+//                 deadband, or when it has been silent for the heartbeat
+//   PUB_BATCH     N timestamped samples in one JSON message on TOPIC_BATCH,
+//                 sent early once the oldest is PUB_BATCH_AGE_MS old
+// Whatever the mode, the counters also track what PUB_FIXED would have
+// sent, so the savings can be read off directly.
+
+#pragma once
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+
+#define PUB_TOPIC_TEMP        "home/lab1/temp"
+#define PUB_TOPIC_HUM         "home/lab1/hum"
+#define PUB_TOPIC_BATCH       "home/lab1/batch"
+
+#define PUB_DEADBAND_TEMP     0.2f      // degrees C
+#define PUB_DEADBAND_HUM      1.0f      // %RH
+#define PUB_HEARTBEAT_MS      60000UL   // max silence per metric
+#define PUB_BATCH_SIZE        6
+#define PUB_BATCH_MAX         16
+#define PUB_BATCH_AGE_MS      60000UL   // max time a sample waits in a batch
+
+// Batch payload: {"t0":<10 digits>,"s":[ ... ]} plus one row per sample,
+// [<dt>,<temp>,<hum>] with its comma at most PUB_ROW_CHARS long
+#define PUB_ROW_CHARS         32
+#define PUB_PAYLOAD_HEAD      24
+#define PUB_PAYLOAD_MAX       (PUB_PAYLOAD_HEAD + PUB_BATCH_MAX * PUB_ROW_CHARS + 3)
+// Whole PUBLISH packet as PubSubClient buffers it: 5 header bytes, topic, payload
+#define PUB_PACKET_MAX        (5 + 2 + sizeof(PUB_TOPIC_BATCH) - 1 + PUB_PAYLOAD_MAX)
+
+enum PublishMode : uint8_t {
+    PUB_FIXED = 0,
+    PUB_DEADBAND,
+    PUB_BATCH
+};
+
+struct PublishCounters {
+    uint32_t samples;
+    uint32_t messages;          // actually published
+    uint32_t bytes;             // MQTT packet bytes, QoS 0
+    uint32_t fixedMessages;     // what PUB_FIXED would have published
+    uint32_t fixedBytes;
+
+    int32_t messagesAvoided() const { return (int32_t)fixedMessages - (int32_t)messages; }
+    int32_t bytesAvoided() const { return (int32_t)fixedBytes - (int32_t)bytes; }
+};
+
+struct Deadband {
+    float band;
+    float last;        // last value published
+    uint32_t lastAt;   // millis() of that publish
+    bool valid;
+
+    bool due(float v, uint32_t nowMs) const {
+        return !valid || fabsf(v - last) >= band || nowMs - lastAt >= PUB_HEARTBEAT_MS;
+    }
+    void mark(float v, uint32_t nowMs) { last = v; lastAt = nowMs; valid = true; }
+};
+
+class SamplePublisher {
+public:
+    SamplePublisher(PubSubClient& client, PublishMode mode = PUB_DEADBAND);
+
+    // Grows the client's packet buffer to PUB_PACKET_MAX so that a full
+    // batch fits; without that the batch size is clamped to the buffer
+    bool begin();
+
+    void setMode(PublishMode m) { mode = m; }
+    void setBatchSize(uint8_t n);   // clamped to 1..batchCapacity()
+    void setBatchAge(uint32_t ms) { batchAgeMs = ms; }
+    uint8_t batchCapacity() const;  // rows that fit the client's buffer
+
+    // One DHT sample; timestamp is millis() at capture
+    void add(uint32_t timestamp, float temperature, float humidity);
+    void poll(uint32_t nowMs);   // sends a batch whose oldest sample is too old
+    void flush();   // sends a partial batch
+
+    const PublishCounters& stats() const { return counters; }
+    void printStats(Print& out) const;
+
+    // Size of a QoS 0 PUBLISH packet
+    static uint32_t packetBytes(const char* topic, size_t payloadLen);
+
+private:
+    struct Row {
+        uint32_t t;
+        float temperature;
+        float humidity;
+    };
+
+    bool send(const char* topic, const char* payload);
+
+    PubSubClient& client;
+    PublishMode mode;
+    uint8_t batchSize;
+    uint32_t batchAgeMs;
+    Deadband temp;
+    Deadband hum;
+    Row batch[PUB_BATCH_MAX];
+    uint8_t batched;
+    PublishCounters counters;
+};
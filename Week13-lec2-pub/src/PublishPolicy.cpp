@@ -0,0 +1,103 @@
+#include "PublishPolicy.h"
+
+static const char* const modeNames[] = { "fixed", "deadband", "batch" };
+
+SamplePublisher::SamplePublisher(PubSubClient& client, PublishMode mode)
+    : client(client), mode(mode), batchSize(PUB_BATCH_SIZE), batchAgeMs(PUB_BATCH_AGE_MS),
+      batched(0), counters() {
+    temp = { PUB_DEADBAND_TEMP, 0, 0, false };
+    hum = { PUB_DEADBAND_HUM, 0, 0, false };
+}
+
+bool SamplePublisher::begin() {
+    bool grown = client.getBufferSize() >= PUB_PACKET_MAX || client.setBufferSize(PUB_PACKET_MAX);
+    setBatchSize(batchSize);
+    return grown;
+}
+
+uint8_t SamplePublisher::batchCapacity() const {
+    const uint32_t fixed = PUB_PACKET_MAX - PUB_BATCH_MAX * PUB_ROW_CHARS;
+    uint32_t buffer = client.getBufferSize();
+    uint32_t rows = buffer > fixed ? (buffer - fixed) / PUB_ROW_CHARS : 0;
+    return rows < PUB_BATCH_MAX ? rows : PUB_BATCH_MAX;
+}
+
+void SamplePublisher::setBatchSize(uint8_t n) {
+    uint8_t cap = batchCapacity();
+    if (cap < 1) cap = 1;
+    batchSize = n < 1 ? 1 : n > cap ? cap : n;
+}
+
+uint32_t SamplePublisher::packetBytes(const char* topic, size_t payloadLen) {
+    uint32_t remaining = 2 + strlen(topic) + payloadLen;   // topic length + topic + payload
+    uint32_t lenBytes = remaining < 128 ? 1 : remaining < 16384 ? 2 : 3;
+    return 1 + lenBytes + remaining;
+}
+
+bool SamplePublisher::send(const char* topic, const char* payload) {
+    if (!client.publish(topic, payload)) return false;
+    counters.messages++;
+    counters.bytes += packetBytes(topic, strlen(payload));
+    return true;
+}
+
+void SamplePublisher::add(uint32_t timestamp, float temperature, float humidity) {
+    char tBuf[8], hBuf[8];
+    dtostrf(temperature, 4, 2, tBuf);
+    dtostrf(humidity,    4, 2, hBuf);
+
+    counters.samples++;
+    counters.fixedMessages += 2;
+    counters.fixedBytes += packetBytes(PUB_TOPIC_TEMP, strlen(tBuf)) + packetBytes(PUB_TOPIC_HUM, strlen(hBuf));
+
+    switch (mode) {
+        case PUB_FIXED:
+            send(PUB_TOPIC_TEMP, tBuf);
+            send(PUB_TOPIC_HUM, hBuf);
+            break;
+
+        case PUB_DEADBAND:
+            if (temp.due(temperature, timestamp) && send(PUB_TOPIC_TEMP, tBuf)) temp.mark(temperature, timestamp);
+            if (hum.due(humidity, timestamp) && send(PUB_TOPIC_HUM, hBuf)) hum.mark(humidity, timestamp);
+            break;
+
+        case PUB_BATCH:
+            batch[batched++] = { timestamp, temperature, humidity };
+            if (batched >= batchSize || timestamp - batch[0].t >= batchAgeMs) flush();
+            break;
+    }
+}
+
+void SamplePublisher::poll(uint32_t nowMs) {
+    if (batched && nowMs - batch[0].t >= batchAgeMs) flush();
+}
+
+// {"t0":<s since boot>,"s":[[dt,temp,hum],...]} with dt in seconds from t0
+void SamplePublisher::flush() {
+    if (!batched) return;
+
+    static char payload[PUB_PAYLOAD_MAX];
+    uint32_t t0 = batch[0].t / 1000;
+    size_t used = snprintf(payload, sizeof(payload), "{\"t0\":%lu,\"s\":[", (unsigned long)t0);
+    for (uint8_t i = 0; i < batched && used < sizeof(payload); i++) {
+        used += snprintf(payload + used, sizeof(payload) - used, "%s[%lu,%.2f,%.2f]", i ? "," : "",
+                         (unsigned long)(batch[i].t / 1000 - t0), batch[i].temperature, batch[i].humidity);
+    }
+    if (used < sizeof(payload)) snprintf(payload + used, sizeof(payload) - used, "]}");
+
+    // On failure keep the rows; the oldest are dropped once the batch is full
+    if (send(PUB_TOPIC_BATCH, payload)) {
+        batched = 0;
+    } else if (batched >= batchSize) {
+        uint8_t drop = batched - batchSize + 1;
+        memmove(batch, batch + drop, (batched - drop) * sizeof(Row));
+        batched -= drop;
+    }
+}
+
+void SamplePublisher::printStats(Print& out) const {
+    out.printf("[pub %s] samples %lu | msgs %lu (fixed %lu, avoided %ld) | bytes %lu (fixed %lu, avoided %ld)\n",
+               modeNames[mode], (unsigned long)counters.samples,
+               (unsigned long)counters.messages, (unsigned long)counters.fixedMessages, (long)counters.messagesAvoided(),
+               (unsigned long)counters.bytes, (unsigned long)counters.fixedBytes, (long)counters.bytesAvoided());
+}
@@ -1,14 +1,20 @@
 /****************************************************
  * ESP32 + DHT22 + MQTT (PUBLISHER ONLY)
  * Topic:
- *   home/lab1/temp
- *   home/lab1/hum
+ *   home/lab1/temp    PUB_FIXED / PUB_DEADBAND
+ *   home/lab1/hum     PUB_FIXED / PUB_DEADBAND
+ *   home/lab1/batch   PUB_BATCH: N timestamped samples per message
+ *   home/lab1/stats   per-minute min/avg/max from the local history
  ****************************************************/
 
 #include <Arduino.h>
 #include <WiFi.h>
 #include <PubSubClient.h>
-#include "DHT.h"
+#include <RmtDHT.h>
+#include <SensorSources.h>
+#include <NetManager.h>
+#include <TimeSeries.h>
+#include "PublishPolicy.h"
 
 // ---------- WiFi ----------
 char ssid[] = "Wokwi-GUEST";
@@ -18,80 +24,109 @@ char pass[] = "";
 const char* mqtt_server = "10.13.20.253";  // Mosquitto / Cloud broker
 const int   mqtt_port   = 1883;
 
-// Topics
-const char* TOPIC_TEMP = "home/lab1/temp";
-const char* TOPIC_HUM  = "home/lab1/hum";
+// Topics (sample topics are in PublishPolicy.h)
+const char* TOPIC_STATS = "home/lab1/stats";
+
+// PUB_FIXED, PUB_DEADBAND or PUB_BATCH
+#define PUBLISH_MODE PUB_DEADBAND
 
 // ---------- DHT ----------
 #define DHTPIN  23
 #define DHTTYPE DHT22
-DHT dht(DHTPIN, DHTTYPE);
+RmtDHT dht(DHTPIN, DHTTYPE);   // samples arrive through dht.read()
 
 // ---------- MQTT Client ----------
 WiFiClient espClient;
 PubSubClient mqtt(espClient);
+NetManager net;
+SamplePublisher publisher(mqtt, PUBLISH_MODE);
+
+// ---------- History (seconds since boot) ----------
+// Kept while MQTT is down too, so minute stats are caught up on reconnect
+TimeSeries<12> tempHistory;
+TimeSeries<12> humHistory;
+uint32_t statsFrom = 0;   // first minute not yet published
+
+// ---------- Timing ----------
+#define PUBLISH_INTERVAL_MS 5000   // sample every 5 seconds (failed reads retry sooner)
+#define STATS_REPORT_MS     60000  // publisher counters to Serial
+unsigned long lastReport = 0;
 
 // ---------- Functions ----------
-void connectWiFi() {
-  Serial.print("Connecting to WiFi");
-  WiFi.begin(ssid, pass);
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
+// One MQTT connection attempt; NetManager paces the retries
+bool connectMQTT() {
+  Serial.print("Connecting to MQTT...");
+  if (mqtt.connect("ESP32_Publisher-1")) {
+    Serial.println("connected");
+    return true;
   }
-  Serial.println("\nWiFi connected");
+  Serial.print("failed, rc=");
+  Serial.println(mqtt.state());
+  return false;
 }
 
-void connectMQTT() {
-  while (!mqtt.connected()) {
-    Serial.print("Connecting to MQTT...");
-    if (mqtt.connect("ESP32_Publisher-1")) {
-      Serial.println("connected");
-    } else {
-      Serial.print("failed, rc=");
-      Serial.println(mqtt.state());
-      delay(2000);
-    }
+bool mqttConnected() { return mqtt.connected(); }
+void mqttService()   { mqtt.loop(); }
+
+// Publishes every completed minute still in the history
+void publishMinuteStats(uint32_t now) {
+  uint32_t current = now - now % TS_MINUTE_SECONDS;
+  uint32_t retained = TS_MINUTE_SECONDS * TimeSeries<12>::capacity(TS_MINUTE);
+  if (current - statsFrom > retained) statsFrom = current - retained;
+
+  for (; statsFrom < current; statsFrom += TS_MINUTE_SECONDS) {
+    const TsAggregate* t = tempHistory.bucket(TS_MINUTE, statsFrom);
+    const TsAggregate* h = humHistory.bucket(TS_MINUTE, statsFrom);
+    if (!t || !h) continue;
+
+    char payload[128];
+    snprintf(payload, sizeof(payload),
+             "{\"t\":%lu,\"n\":%u,\"temp\":[%.2f,%.2f,%.2f],\"hum\":[%.2f,%.2f,%.2f]}",
+             (unsigned long)statsFrom, t->count, t->min, t->avg(), t->max, h->min, h->avg(), h->max);
+    if (!mqtt.publish(TOPIC_STATS, payload)) break;   // retry this minute later
+  }
+}
+
+// Valid samples: history first, then whatever the policy sends
+void publishSample(const SensorFrame& f) {
+  uint32_t now = f.timestamp / 1000;
+  tempHistory.add(now, f.temperature);
+  humHistory.add(now, f.humidity);
+
+  if (!mqtt.connected()) {
+    Serial.println("MQTT down, sample kept in history only");
+    return;
   }
+  publishMinuteStats(now);
+  publisher.add(f.timestamp, f.temperature, f.humidity);
 }
 
+// ---------- Node: DHT -> Serial, valid samples -> history + MQTT ----------
+auto node = makePipeline(dhtSource(dht), printSink(Serial),
+                         requireFields(FRAME_TEMP | FRAME_HUM),
+                         callSink(publishSample));
+
 void setup() {
   Serial.begin(115200);
 
-  dht.begin();
-  connectWiFi();
+  dht.begin(PUBLISH_INTERVAL_MS);
 
+  // WiFi + MQTT connect in the background, driven by net.loop()
+  espClient.setTimeout(1);
   mqtt.setServer(mqtt_server, mqtt_port);
-  connectMQTT();
+  if (!publisher.begin()) Serial.println("MQTT buffer not grown, batches limited");
+  net.begin(ssid, pass);
+  net.addLink("MQTT", connectMQTT, mqttConnected, mqttService);
 }
 
 void loop() {
-  if (!mqtt.connected()) {
-    connectMQTT();
-  }
-  mqtt.loop();
-
-  float temperature = dht.readTemperature();
-  float humidity    = dht.readHumidity();
+  net.loop();
 
-  if (isnan(temperature) || isnan(humidity)) {
-    Serial.println("DHT read failed");
-    delay(2000);
-    return;
+  if (millis() - lastReport >= STATS_REPORT_MS) {
+    lastReport = millis();
+    publisher.printStats(Serial);
   }
 
-  char tBuf[8], hBuf[8];
-  dtostrf(temperature, 4, 2, tBuf);
-  dtostrf(humidity,    4, 2, hBuf);
-
-  mqtt.publish(TOPIC_TEMP, tBuf);
-  mqtt.publish(TOPIC_HUM,  hBuf);
-
-  Serial.print("Published -> Temp: ");
-  Serial.print(tBuf);
-  Serial.print(" C | Hum: ");
-  Serial.print(hBuf);
-  Serial.println(" %");
-
-  delay(5000);  // publish every 5 seconds
+  node.step();
+  if (mqtt.connected()) publisher.poll(millis());   // batch age, for slow sensors
 }
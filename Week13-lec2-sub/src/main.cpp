@@ -10,6 +10,8 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <PagedSSD1306.h>
+#include <NetManager.h>
 
 // ---------- WiFi ----------
 char ssid[] = "Wokwi-GUEST";
@@ -25,17 +27,49 @@ const char* TOPIC_TEMP = "home/node-red/temp"; // Topic for temperature
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define OLED_RESET -1
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+PagedSSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 
 // ---------- MQTT ----------
 WiFiClient espClient;
 PubSubClient mqtt(espClient);
-
-// latest temperature
-String lastTemp = "--"; // initial display value
+NetManager net;
+
+// ---------- Latest value mailbox ----------
+// The MQTT callback only parses into here; the OLED is redrawn from loop()
+// at most RENDER_FPS times a second, so a burst of messages costs one frame.
+#define RENDER_FPS 5
+
+struct TempMailbox {
+  float value;         // NAN until the first valid message
+  uint32_t received;   // messages taken
+  uint32_t rejected;   // payloads that were not a number
+  bool dirty;          // changed since the last frame
+};
+TempMailbox temp = { NAN, 0, 0, true };   // draw the initial screen once
+
+unsigned long lastFrame = 0;
+uint32_t frames = 0;
+
+#define STATS_REPORT_MS 10000
+unsigned long lastReport = 0;
+
+// Parses "23.5" (surrounding whitespace allowed) without building a String
+bool parseFloat(const byte* payload, unsigned int length, float& out) {
+  char buf[16];
+  if (length >= sizeof(buf)) return false;
+  memcpy(buf, payload, length);
+  buf[length] = '\0';
+
+  char* end;
+  float v = strtof(buf, &end);
+  if (end == buf) return false;
+  while (isspace((unsigned char)*end)) end++;
+  if (*end != '\0' || isnan(v)) return false;
+  out = v;
+  return true;
+}
 
 // Function to update OLED display
-
 void showTemp() {
   display.clearDisplay();
   display.setTextColor(SSD1306_WHITE);
@@ -49,7 +83,8 @@ void showTemp() {
   display.setTextSize(1);
   display.setCursor(0, 25);
   display.print("Temp: ");
-  display.print(lastTemp);
+  if (isnan(temp.value)) display.print("--");
+  else display.print(temp.value, 1);
   display.println("C");
 
   display.display();
@@ -57,44 +92,45 @@ void showTemp() {
 
 // MQTT callback: runs when message arrives
 void callback(char* topic, byte* payload, unsigned int length) {
-  String msg = "";
-  for (unsigned int i = 0; i < length; i++) msg += (char)payload[i];
-  msg.trim();
-
-  if (String(topic) == TOPIC_TEMP) {
-    lastTemp = msg;   // store received value
-    Serial.print("Temp received: ");
-    Serial.println(lastTemp);
-    showTemp();       // update OLED
+  if (strcmp(topic, TOPIC_TEMP) != 0) return;
+
+  float v;
+  if (!parseFloat(payload, length, v)) {
+    temp.rejected++;
+    return;
+  }
+  temp.received++;
+  if (v != temp.value) {
+    temp.value = v;
+    temp.dirty = true;
   }
 }
 
-void connectWiFi() {
-  Serial.print("Connecting WiFi");
-  WiFi.begin(ssid, pass);
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
-  }
-  Serial.println("\nWiFi connected");
+// Draws the latest value, no more often than RENDER_FPS
+void render() {
+  if (!temp.dirty || millis() - lastFrame < 1000 / RENDER_FPS) return;
+  lastFrame = millis();
+  temp.dirty = false;
+  frames++;
+  showTemp();
 }
 
-// Connect to MQTT broker as subscriber
-void connectMQTT() {
-  while (!mqtt.connected()) {
-    Serial.print("Connecting MQTT...");
-    if (mqtt.connect("subscriber-1")) {
-      Serial.println("connected");
-      mqtt.subscribe(TOPIC_TEMP);
-      showTemp();
-    } else {
-      Serial.print("failed rc=");
-      Serial.println(mqtt.state());
-      delay(2000);
-    }
+// One MQTT connection attempt as subscriber; NetManager paces the retries
+bool connectMQTT() {
+  Serial.print("Connecting MQTT...");
+  if (mqtt.connect("subscriber-1")) {
+    Serial.println("connected");
+    mqtt.subscribe(TOPIC_TEMP);
+    return true;
   }
+  Serial.print("failed rc=");
+  Serial.println(mqtt.state());
+  return false;
 }
 
+bool mqttConnected() { return mqtt.connected(); }
+void mqttService()   { mqtt.loop(); }
+
 void setup() {
   Serial.begin(115200);
 
@@ -107,15 +143,23 @@ void setup() {
   display.clearDisplay();
   display.display();
 
-  showTemp();       // initial screen
-  connectWiFi();
-
+  espClient.setTimeout(1);
   mqtt.setServer(mqtt_server, mqtt_port); // MQTT broker
   mqtt.setCallback(callback);
-  connectMQTT();
+
+  // WiFi + MQTT connect in the background, driven by net.loop()
+  net.begin(ssid, pass);
+  net.addLink("MQTT", connectMQTT, mqttConnected, mqttService);
 }
 
 void loop() {
-  if (!mqtt.connected()) connectMQTT();
-  mqtt.loop(); 
+  net.loop();
+  render();
+
+  if (millis() - lastReport >= STATS_REPORT_MS) {
+    lastReport = millis();
+    Serial.printf("Temp: %.1f C | %lu msg, %lu frames, %lu rejected\n",
+                  temp.value, (unsigned long)temp.received,
+                  (unsigned long)frames, (unsigned long)temp.rejected);
+  }
 }
@@ -1,31 +1,59 @@
 #include <Arduino.h>
+#include <TimerScheduler.h>
 
 #define LED_PIN 2            // GPIO4 for LED
-hw_timer_t *My_timer = nullptr;
+#define REPORT_US 5000000    // stats every 5 s
+
+// Hardware timer 0, shared by every callback below
+TimerScheduler timers;
+int8_t blinkTimer, countTimer;
+volatile uint32_t ticks = 0;
+
+// ---- Timer callbacks ----
+// In the ISR: IRAM only, so the LED is toggled through the GPIO registers
+// (digitalRead()/digitalWrite() live in flash)
+void IRAM_ATTR onBlink(void*) {
+  gpioFastToggle(LED_PIN);
+}
+
+// In the scheduler task: any code may run here
+void onCount(void*) {
+  ticks++;
+}
 
-// ---- Timer ISR ----
-void IRAM_ATTR onTimer() {
-  digitalWrite(LED_PIN, !digitalRead(LED_PIN));  // toggle LED
+void printStats(const char* name, int8_t id) {
+  TimerStats s = timers.stats(id);
+  Serial.printf("%-6s runs %lu missed %lu | jitter max %lu us avg %lu us | run max %lu ns avg %lu ns\n",
+                name, (unsigned long)s.runs, (unsigned long)s.missed,
+                (unsigned long)s.jitterMaxUs, (unsigned long)s.jitterAvgUs,
+                (unsigned long)s.runMaxNs, (unsigned long)s.runAvgNs);
+}
+
+void onReport(void*) {
+  printStats("blink", blinkTimer);
+  printStats("count", countTimer);
+  Serial.printf("ISR: %lu alarms, worst %lu ns, count = %lu\n",
+                (unsigned long)timers.isrCount(), (unsigned long)timers.isrMaxNs(),
+                (unsigned long)ticks);
 }
 
 // ---- Setup ----
 void setup() {
+  Serial.begin(115200);
   pinMode(LED_PIN, OUTPUT);
 
-  // timerBegin(timer number 0-3, prescaler, countUp)
-  // 80 MHz / 80 = 1 MHz → tick = 1 µs
-  My_timer = timerBegin(0, 80, true);
-
-  // attach ISR to timer, edge-triggered
-  timerAttachInterrupt(My_timer, &onTimer, true);
+  // 80 MHz / 80 = 1 MHz -> tick = 1 us; the alarm is moved to the
+  // nearest deadline each time it fires
+  timers.begin();
 
-  // trigger every 1 000 000 µs = 1 s
-  timerAlarmWrite(My_timer, 1000000, true);
+  blinkTimer = timers.every(1000000, onBlink, nullptr, TIMER_IN_ISR);   // 1 s
+  countTimer = timers.every(10000, onCount);                           // 10 ms
+  timers.every(REPORT_US, onReport);
 
-  // enable alarm
-  timerAlarmEnable(My_timer);
+  // One-shot: the first report early, after 1.5 s
+  timers.after(1500000, onReport);
 }
 
 void loop() {
   // main loop free for other code
-}
\ No newline at end of file
+}
@@ -1,9 +1,14 @@
 // PWM + Buzzer + Two LEDs (concurrent)
 // LED pins: 18 and 19 (fade together)
 // Buzzer pin: 27 (tones)
-// ESP32: uses separate LEDC channels and a FreeRTOS task for LED fading
+// ESP32: uses separate LEDC channels; the LEDs fade in the LEDC hardware
+// (LedcFader) and the buzzer plays note tables from timer callbacks
+// (ToneSequencer), so neither costs loop() time
 
 #include <Arduino.h>
+#include <LedcFader.h>
+#include <ToneSequencer.h>
+#include <esp_timer.h>
 
 // Pins
 #define LED_PIN1      18
@@ -23,27 +28,58 @@
 #define LED_FREQ      1000    // 1kHz PWM for LEDs
 #define LED_RES       8       // 8-bit resolution (0..255)
 
-// Task handle
-TaskHandle_t ledTaskHandle = NULL;
+// LED fade: 0 -> 255 -> 0, 2.55 s each way, repeated by the hardware
+const FadeRamp BREATHE[] = { { 255, 2550 }, { 0, 2550 } };
 
-void ledFadeTask(void *param) {
-  // simple up/down fade for both LEDs in sync
-  const int stepDelay = 10; // ms per brightness step
-  int d = 0;
-  int dir = 1; // 1 -> up, -1 -> down
+// The software fade this replaces woke a task every FADE_STEP_MS for one
+// brightness step; used for the comparison printed every REPORT_MS
+#define FADE_STEP_MS  10
+#define REPORT_MS     10000
 
-  for (;;) {
-    // write brightness to both LED channels
-    ledcWrite(LED1_CH, d);
-    ledcWrite(LED2_CH, d);
+LedcFader fader;
+ToneSequencer buzzer(BUZZER_CH);
+
+// --- Buzzer program: { frequency Hz, duration ms, silence after ms } ---
+
+// 1) Simple beep pattern
+const Note BEEPS[] = {
+  { 2000, 150, 150 }, { 2400, 150, 150 }, { 2800, 150, 150 },
+};
 
-    // step
-    d += dir;
-    if (d >= 255) { d = 255; dir = -1; }
-    if (d <= 0)   { d = 0;   dir = 1; }
+// 2) Frequency sweep (400Hz -> 3kHz), 20 ms per step, filled in setup()
+#define SWEEP_STEPS 27
+Note sweep[SWEEP_STEPS];
 
-    vTaskDelay(stepDelay / portTICK_PERIOD_MS);
+// 3) Short melody, then a pause before repeating
+const Note MELODY[] = {
+  { 262, 250, 0 }, { 294, 250, 0 }, { 330, 250, 0 }, { 349, 250, 0 },
+  { 392, 250, 0 }, { 440, 250, 0 }, { 494, 250, 0 }, { 523, 250, 500 },
+};
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+uint32_t fadeStart = 0;
+uint32_t softStepNs = 0;   // CPU time of one software fade step
+
+// Times the body of the old fade task (two LEDC writes) once at boot
+void measureSoftwareStep() {
+  const int runs = 256;
+  int64_t t0 = esp_timer_get_time();
+  for (int d = 0; d < runs; d++) {
+    ledcWrite(LED1_CH, d);
+    ledcWrite(LED2_CH, d);
   }
+  softStepNs = (uint32_t)((esp_timer_get_time() - t0) * 1000 / runs);
+}
+
+void reportFadeCost() {
+  FadeStats s = fader.stats();
+  uint32_t softWakeups = (millis() - fadeStart) / FADE_STEP_MS;
+  uint32_t softUs = (uint64_t)softWakeups * softStepNs / 1000;
+  Serial.printf("Fade: hardware %lu wakeups, %lu us CPU | 10 ms task would have: %lu wakeups, %lu us CPU"
+                " (+ a context switch each)\n",
+                (unsigned long)s.wakeups, (unsigned long)s.busyUs,
+                (unsigned long)softWakeups, (unsigned long)softUs);
 }
 
 void setup() {
@@ -56,73 +92,43 @@ void setup() {
 
   ledcSetup(LED2_CH, LED_FREQ, LED_RES);
   ledcAttachPin(LED_PIN2, LED2_CH);
+  measureSoftwareStep();
 
   // Setup buzzer channel
   ledcSetup(BUZZER_CH, BUZZER_FREQ, BUZZER_RES);
   ledcAttachPin(BUZZER_PIN, BUZZER_CH);
+  buzzer.begin();
 
-  // Start LED fade task (runs concurrently)
-  xTaskCreate(
-    ledFadeTask,        // function
-    "LED Fade Task",    // name
-    2048,               // stack size
-    NULL,               // param
-    1,                  // priority
-    &ledTaskHandle
-  );
-
-  // --- Initial buzzer demo (runs while LEDs fade) ---
-
-  // 1) Simple beep pattern
-  for (int i = 0; i < 3; i++) {
-    ledcWriteTone(BUZZER_CH, 2000 + i * 400); // change tone
-    delay(150);
-    ledcWrite(BUZZER_CH, 0);                  // stop tone
-    delay(150);
+  for (int i = 0; i < SWEEP_STEPS; i++) {
+    sweep[i] = { (uint16_t)(400 + i * 100), 20, 0 };
   }
-
-  // 2) Frequency sweep (400Hz → 3kHz)
-  for (int f = 400; f <= 3000; f += 100) {
-    ledcWriteTone(BUZZER_CH, f);
-    delay(20);
-  }
-  ledcWrite(BUZZER_CH, 0);
-  delay(500);
-
-  // 3) Short melody
-  int melody[] = {262, 294, 330, 349, 392, 440, 494, 523};
-  for (int i = 0; i < 8; i++) {
-    ledcWriteTone(BUZZER_CH, melody[i]);
-    delay(250);
-  }
-  ledcWrite(BUZZER_CH, 0); // stop buzzer
+  sweep[SWEEP_STEPS - 1].gapMs = 500;
+
+  // Start the LED fade: both channels from 0, in sync, forever
+  ledcWrite(LED1_CH, 0);
+  ledcWrite(LED2_CH, 0);
+  fader.begin();
+  fader.attach(LED1_CH, LED_RES);
+  fader.attach(LED2_CH, LED_RES);
+  fader.play(LED1_CH, BREATHE, COUNT(BREATHE), true);
+  fader.play(LED2_CH, BREATHE, COUNT(BREATHE), true);
+  fadeStart = millis();
 }
 
 void loop() {
-  // Repeat the buzzer sequence while the LED fade task runs
-  // 1) Simple beep pattern
-  for (int i = 0; i < 3; i++) {
-    ledcWriteTone(BUZZER_CH, 2000 + i * 400);
-    delay(150);
-    ledcWrite(BUZZER_CH, 0);
-    delay(150);
+  // Queue the next round as soon as the buzzer is idle; the sequencer
+  // times every note, so loop() is free for anything else meanwhile
+  if (!buzzer.busy()) {
+    buzzer.play(BEEPS, COUNT(BEEPS));
+    buzzer.play(sweep, SWEEP_STEPS);
+    buzzer.play(MELODY, COUNT(MELODY));
   }
 
-  // 2) Frequency sweep (400Hz → 3kHz)
-  for (int f = 400; f <= 3000; f += 100) {
-    ledcWriteTone(BUZZER_CH, f);
-    delay(20);
-  }
-  ledcWrite(BUZZER_CH, 0);
-  delay(500);
-
-  // 3) Short melody
-  int melody[] = {262, 294, 330, 349, 392, 440, 494, 523};
-  for (int i = 0; i < 8; i++) {
-    ledcWriteTone(BUZZER_CH, melody[i]);
-    delay(250);
+  static uint32_t lastReport = 0;
+  if (millis() - lastReport >= REPORT_MS) {
+    lastReport = millis();
+    reportFadeCost();
   }
-  ledcWrite(BUZZER_CH, 0); // stop buzzer
 
-  delay(500); // small pause before repeating
+  delay(10);
 }
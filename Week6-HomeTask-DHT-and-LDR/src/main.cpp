@@ -20,12 +20,16 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
-#include <DHT.h>
+#include <PagedSSD1306.h>
+#include <RmtDHT.h>
+#include <LdrAdc.h>
+#include <SensorSources.h>
+#include <LightSource.h>
 
 // ---------------------- Pin Configuration ----------------------
 #define DHTPIN 14          // DHT11 data pin connected to GPIO14
 #define DHTTYPE DHT11      // Specify sensor type (DHT11)
-#define LDR_PIN 34         // LDR analog input pin
+#define LDR_PIN 34         // LDR analog input pin (ADC1 channel 6)
 
 #define SDA_PIN 21         // I2C SDA pin for OLED
 #define SCL_PIN 22         // I2C SCL pin for OLED
@@ -35,10 +39,16 @@
 #define SCREEN_HEIGHT 64   // OLED height in pixels
 
 // Create display object using I2C communication
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+PagedSSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 
 // ---------------------- Sensor Object ---------------------------
-DHT dht(DHTPIN, DHTTYPE);  // Initialize DHT sensor
+RmtDHT dht(DHTPIN, DHTTYPE);  // RMT capture, decoded in a background task
+LdrAdc ldr(ADC1_CHANNEL_6);   // continuous DMA sampling, fixed-point filtered
+
+// ---------------------- Node ------------------------------------
+// DHT sample + latest LDR reading -> Serial line + OLED
+auto node = makePipeline(dhtSource(dht), withLight(ldr),
+                         printSink(Serial), oledSink(display, "Hello IoT"));
 
 // ============================================================================
 // Setup Function: Runs once during startup
@@ -65,71 +75,16 @@ void setup() {
   display.display();
   delay(500);
 
-  // Start DHT11 sensor
-  dht.begin();
-  delay(1000);
+  // Start DHT11 sampling every 2 seconds
+  dht.begin(2000);
+
+  // LDR: 20 kHz DMA stream averaged down to 2 readings per second
+  ldr.begin(2);
 }
 
 // ============================================================================
-// Loop Function: Continuously reads sensors and updates display
+// Loop Function: Each new DHT sample (or read error) goes through the node
 // ============================================================================
 void loop() {
-  // ----------- Read Temperature and Humidity from DHT11 -----------
-  float temperature = dht.readTemperature();   // °C
-  float humidity = dht.readHumidity();         // %
-
-  // ----------- Read LDR Analog Value -----------
-  int adcValue = analogRead(LDR_PIN);          // Range: 0–4095 for ESP32 ADC
-  float voltage = (adcValue / 4095.0) * 3.3;   // Convert ADC value to voltage
-
-  // ----------- Print Data to Serial Monitor -----------
-  if (isnan(temperature) || isnan(humidity)) {
-    Serial.println("Error reading DHT11 sensor! (Skipping T/H)");
-  } else {
-    Serial.printf("Temp: %.1f °C | Humidity: %.1f %%\n", temperature, humidity);
-  }
-  Serial.printf("LDR ADC: %d | Voltage: %.2f V\n", adcValue, voltage);
-  Serial.println("---------------------------------");
-
-  // ----------- Display Data on OLED -----------
-  display.clearDisplay();
-  display.setTextColor(SSD1306_WHITE);
-
-  // Title
-  display.setTextSize(1);
-  display.setCursor(0, 0);
-  display.println("Hello IoT");
-
-  // Temperature & Humidity Section
-  display.setTextSize(1);
-  if (!isnan(temperature) && !isnan(humidity)) {
-    display.setCursor(0, 16);
-    display.print("Temp: ");
-    display.print(temperature, 1);
-    display.print((char)247);  // Degree symbol
-    display.println("C");
-
-    display.setCursor(0, 32);
-    display.print("Humidity: ");
-    display.print(humidity, 0);
-    display.println(" %");
-  } else {
-    display.setCursor(0, 16);
-    display.println("T/H Read Error!");
-  }
-
-  // LDR Section
-  display.setTextSize(1);
-  display.setCursor(0, 54);
-  display.print("LDR:");
-  display.print(adcValue);
-  display.print(" / ");
-  display.print(voltage, 2);
-  display.println("V");
-
-  // Update OLED
-  display.display();
-
-  // Delay before next reading
-  delay(2000);
+  node.step();
 }
@@ -2,7 +2,8 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
-#include <DHT.h>
+#include <RmtDHT.h>
+#include <SensorSources.h>
 
 // --- Pin configuration ---
 #define DHTPIN 14        // DHT22 data pin
@@ -16,8 +17,11 @@
 #define SCREEN_HEIGHT 64
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 
-// --- DHT sensor setup ---
-DHT dht(DHTPIN, DHTTYPE);
+// --- DHT sensor setup (sampled in the background by the RMT driver) ---
+RmtDHT dht(DHTPIN, DHTTYPE);
+
+// --- Node: DHT -> Serial + OLED ---
+auto node = makePipeline(dhtSource(dht), printSink(Serial), oledSink(display, "Hello IoT"));
 
 // --- Setup function ---
 void setup() {
@@ -39,43 +43,12 @@ void setup() {
   display.println("Initializing...");
   display.display();
 
-  // Initialize DHT sensor
-  dht.begin();
-  delay(1000);
+  // Initialize DHT sensor: a new sample every 2 seconds
+  dht.begin(2000);
 }
 
 // --- Main loop ---
 void loop() {
-  float temperature = dht.readTemperature();
-  float humidity = dht.readHumidity();
-
-  // Check if read failed
-  if (isnan(temperature) || isnan(humidity)) {
-    Serial.println("Error reading DHT22 sensor!");
-    return;
-  }
-
-  // Print values on Serial Monitor
-  Serial.print("Temperature: ");
-  Serial.print(temperature);
-  Serial.print(" °C  |  Humidity: ");
-  Serial.print(humidity);
-  Serial.println(" %");
-
-  // Display on OLED
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setCursor(0, 0);
-  display.println("Hello IoT");
-  display.setCursor(0, 16);
-  display.print("Temp: ");
-  display.print(temperature);
-  display.println(" C");
-  display.setCursor(0, 32);
-  display.print("Humidity: ");
-  display.print(humidity);
-  display.println(" %");
-  display.display();
-
-  delay(2000); // update every 2 seconds
-}
\ No newline at end of file
+  // Prints and displays each sample as the driver delivers it
+  node.step();
+}
@@ -2,14 +2,16 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <LdrAdc.h>
 
-#define LDR_PIN 34
+#define LDR_PIN 34        // ADC1 channel 6, sampled continuously by LdrAdc
 #define SDA_PIN 21
 #define SCL_PIN 22
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+LdrAdc ldr(ADC1_CHANNEL_6);   // 20 kHz DMA, filtered down to the output rate
 
 void setup() {
   Serial.begin(115200);
@@ -17,19 +19,22 @@ void setup() {
   display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
   display.clearDisplay();
   display.setTextColor(SSD1306_WHITE);
+
+  ldr.begin(1);   // one averaged reading per second
 }
 
 void loop() {
-  int adcValue = analogRead(LDR_PIN);
-  float voltage = (adcValue / 4095.0) * 3.3;
+  LdrReading reading;
+  if (!ldr.read(reading)) return;
 
   display.clearDisplay();
   display.setTextSize(1);
   display.setCursor(0,10);
-  display.print("LDR ADC: "); display.println(adcValue);
-  display.print("Voltage: "); display.print(voltage, 2); display.println(" V");
+  display.print("LDR ADC: "); display.println(reading.counts());
+  display.print("Voltage: "); display.print(reading.volts(), 2); display.println(" V");
+  display.print("Light:   "); display.print(reading.lux(), 0); display.println(" lx");
   display.display();
 
-  Serial.printf("ADC: %d  |  Voltage: %.2f V\n", adcValue, voltage);
-  delay(1000);
-}
\ No newline at end of file
+  Serial.printf("ADC: %u  |  Voltage: %u mV  |  Light: %.1f lx\n",
+                reading.counts(), reading.millivolts, reading.lux());
+}
@@ -0,0 +1,141 @@
+// Event-driven HTTP/1.1 server on lwIP sockets
+// A single select() watches the listening socket and every open connection,
+// so poll() never waits on one slow client. Connections stay open
+// (keep-alive) and pipelined requests are answered in order.
+//
+// The parser is incremental: it resumes where the previous recv() stopped
+// and hands handlers slices pointing into the receive buffer, so nothing
+// is copied into Strings. Request bodies are skipped.
+
+#pragma once
+
+#include <Arduino.h>
+
+#define HTTP_MAX_CLIENTS 4
+#define HTTP_MAX_ROUTES  8
+#define HTTP_RX_LEN      512     // a request line + headers must fit
+#define HTTP_TX_LEN      1024    // a whole response must fit
+#define HTTP_IDLE_MS     10000   // idle keep-alive connections are closed
+#define HTTP_EVICT_MS    1000    // ...or sooner, when a new client needs the slot
+
+// View into the receive buffer; only valid during the handler call
+struct HttpSlice {
+    const char* ptr;
+    uint16_t len;
+
+    bool equals(const char* s) const;
+};
+
+struct HttpRequest {
+    HttpSlice method;
+    HttpSlice path;    // target without the query
+    HttpSlice query;   // after '?', empty if none
+    bool keepAlive;
+};
+
+class HttpResponse {
+public:
+    // Status line, headers and body; false (nothing written) if too large
+    bool send(int code, const char* type, const char* body, size_t len);
+    bool send(int code, const char* type, const char* body) {
+        return send(code, type, body, strlen(body));
+    }
+
+    bool sent() const { return used > 0; }
+
+private:
+    friend class HttpEngine;
+    HttpResponse(char* buf, size_t room, bool keepAlive)
+        : buf(buf), room(room), used(0), keepAlive(keepAlive) {}
+
+    char* buf;
+    size_t room;
+    size_t used;
+    bool keepAlive;
+};
+
+typedef void (*HttpHandler)(const HttpRequest& req, HttpResponse& res);
+
+struct HttpStats {
+    uint32_t accepted;
+    uint32_t requests;
+    uint32_t evicted;    // idle keep-alive connections closed to make room
+    uint32_t errors;     // malformed or oversized requests
+    uint8_t peakClients;
+};
+
+class HttpEngine {
+public:
+    explicit HttpEngine(uint16_t port = 80);
+
+    // Call after WiFi is up
+    bool begin();
+
+    // Exact path match; unmatched requests go to onNotFound (default 404)
+    bool on(const char* path, HttpHandler handler);
+    void onNotFound(HttpHandler handler) { notFound = handler; }
+
+    // Services every ready socket; blocks at most timeoutMs for activity
+    void poll(uint32_t timeoutMs = 0);
+
+    uint8_t clients() const;
+    const HttpStats& stats() const { return counters; }
+
+private:
+    enum ParseState : uint8_t {
+        P_REQUEST_LINE,
+        P_HEADERS,
+        P_DISPATCH,   // head complete, waiting for the previous response to drain
+        P_DISCARD     // skipping a request body
+    };
+
+    struct Span {
+        uint16_t off;
+        uint16_t len;
+    };
+
+    struct Conn {
+        int fd;   // -1 = free slot
+        uint32_t lastActive;
+
+        char rx[HTTP_RX_LEN];
+        uint16_t rxLen;
+        uint16_t head;   // start of the request being parsed
+        uint16_t scan;   // start of the next unparsed line
+        ParseState state;
+        Span method, path, query;
+        bool keepAlive;
+        uint32_t bodyLeft;
+
+        char tx[HTTP_TX_LEN];
+        uint16_t txLen;
+        uint16_t txSent;
+        bool closing;   // close once tx has drained
+    };
+
+    struct Route {
+        const char* path;
+        HttpHandler handler;
+    };
+
+    Conn* freeSlot();
+    void acceptClients();
+    void receive(Conn& c);
+    void process(Conn& c);
+    bool parseRequestLine(Conn& c, uint16_t start, uint16_t len);
+    void parseHeader(Conn& c, uint16_t start, uint16_t len);
+    void dispatch(Conn& c);
+    void fail(Conn& c, int code);
+    void flush(Conn& c);
+    void compact(Conn& c);
+    void drop(Conn& c);
+    HttpSlice slice(const Conn& c, Span s) const { return { c.rx + s.off, s.len }; }
+
+    uint16_t port;
+    int listenFd;
+    Conn conns[HTTP_MAX_CLIENTS];
+    Route routes[HTTP_MAX_ROUTES];
+    uint8_t routeCount;
+    HttpHandler notFound;
+    HttpStats counters;
+};
@@ -0,0 +1,365 @@
+#include "HttpEngine.h"
+
+#include <lwip/sockets.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+static const char* statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        default:  return "";
+    }
+}
+
+static bool sliceEqualsNoCase(const char* p, uint16_t len, const char* s) {
+    return strlen(s) == len && strncasecmp(p, s, len) == 0;
+}
+
+bool HttpSlice::equals(const char* s) const {
+    return strlen(s) == len && memcmp(ptr, s, len) == 0;
+}
+
+bool HttpResponse::send(int code, const char* type, const char* body, size_t len) {
+    int n = snprintf(buf, room,
+                     "HTTP/1.1 %d %s\r\n"
+                     "Content-Type: %s\r\n"
+                     "Content-Length: %u\r\n"
+                     "Connection: %s\r\n\r\n",
+                     code, statusText(code), type, (unsigned)len,
+                     keepAlive ? "keep-alive" : "close");
+    if (n < 0 || (size_t)n + len > room) {
+        used = 0;
+        return false;
+    }
+    memcpy(buf + n, body, len);
+    used = n + len;
+    return true;
+}
+
+HttpEngine::HttpEngine(uint16_t port)
+    : port(port), listenFd(-1), routeCount(0), notFound(nullptr), counters() {
+    for (Conn& c : conns) c.fd = -1;
+}
+
+bool HttpEngine::begin() {
+    listenFd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listenFd < 0) return false;
+
+    int yes = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(listenFd, HTTP_MAX_CLIENTS) < 0) {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL, 0) | O_NONBLOCK);
+    return true;
+}
+
+bool HttpEngine::on(const char* path, HttpHandler handler) {
+    if (routeCount >= HTTP_MAX_ROUTES) return false;
+    routes[routeCount++] = { path, handler };
+    return true;
+}
+
+uint8_t HttpEngine::clients() const {
+    uint8_t n = 0;
+    for (const Conn& c : conns) {
+        if (c.fd >= 0) n++;
+    }
+    return n;
+}
+
+void HttpEngine::poll(uint32_t timeoutMs) {
+    if (listenFd < 0) return;
+
+    fd_set rd, wr;
+    FD_ZERO(&rd);
+    FD_ZERO(&wr);
+    // With every slot busy, new connections wait in the backlog
+    if (freeSlot()) FD_SET(listenFd, &rd);
+    int maxFd = listenFd;
+
+    for (Conn& c : conns) {
+        if (c.fd < 0) continue;
+        // A full buffer that cannot be compacted is not read until it drains
+        if (c.rxLen < HTTP_RX_LEN || c.head > 0) FD_SET(c.fd, &rd);
+        if (c.txLen) FD_SET(c.fd, &wr);
+        if (c.fd > maxFd) maxFd = c.fd;
+    }
+
+    timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    int ready = select(maxFd + 1, &rd, &wr, nullptr, &tv);
+
+    if (ready > 0) {
+        if (FD_ISSET(listenFd, &rd)) acceptClients();
+
+        for (Conn& c : conns) {
+            if (c.fd < 0) continue;
+            // Only sockets that were in the sets can be flagged, so a
+            // connection accepted above is simply skipped this round
+            if (FD_ISSET(c.fd, &wr)) {
+                flush(c);
+                if (c.fd >= 0) process(c);   // resume a stalled pipeline
+            }
+            if (c.fd >= 0 && FD_ISSET(c.fd, &rd)) receive(c);
+        }
+    }
+
+    uint32_t now = millis();
+    for (Conn& c : conns) {
+        if (c.fd < 0) continue;
+        if ((c.closing && !c.txLen) || now - c.lastActive > HTTP_IDLE_MS) drop(c);
+    }
+}
+
+// A free slot, or else the keep-alive connection idle the longest.
+// Connections in the middle of a request, or that just got a reply (the
+// next request may already be on its way), are never evicted.
+HttpEngine::Conn* HttpEngine::freeSlot() {
+    uint32_t now = millis();
+    Conn* idle = nullptr;
+    for (Conn& c : conns) {
+        if (c.fd < 0) return &c;
+        bool between = c.state == P_REQUEST_LINE && c.rxLen == c.head && !c.txLen;
+        if (!between || now - c.lastActive < HTTP_EVICT_MS) continue;
+        if (!idle || now - c.lastActive > now - idle->lastActive) idle = &c;
+    }
+    return idle;
+}
+
+void HttpEngine::acceptClients() {
+    for (;;) {
+        Conn* slot = freeSlot();
+        if (!slot) return;   // the rest wait in the listen backlog
+
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) return;
+
+        if (slot->fd >= 0) {
+            counters.evicted++;
+            drop(*slot);
+        }
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));   // small replies go out now
+
+        Conn& c = *slot;
+        c.fd = fd;
+        c.lastActive = millis();
+        c.rxLen = c.head = c.scan = 0;
+        c.state = P_REQUEST_LINE;
+        c.bodyLeft = 0;
+        c.txLen = c.txSent = 0;
+        c.closing = false;
+
+        counters.accepted++;
+        uint8_t n = clients();
+        if (n > counters.peakClients) counters.peakClients = n;
+    }
+}
+
+void HttpEngine::receive(Conn& c) {
+    if (c.head) compact(c);
+
+    int n = recv(c.fd, c.rx + c.rxLen, HTTP_RX_LEN - c.rxLen, MSG_DONTWAIT);
+    if (n == 0) {
+        drop(c);   // peer closed
+        return;
+    }
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) drop(c);
+        return;
+    }
+    c.rxLen += n;
+    c.lastActive = millis();
+    process(c);
+}
+
+// Runs the parser over whatever has arrived; stops at the end of the data,
+// or when a response is still draining (pipelined replies stay in order)
+void HttpEngine::process(Conn& c) {
+    while (!c.closing) {
+        if (c.state == P_DISPATCH) {
+            if (c.txLen) return;
+            dispatch(c);
+            continue;
+        }
+
+        if (c.state == P_DISCARD) {
+            uint32_t n = min<uint32_t>(c.bodyLeft, c.rxLen - c.scan);
+            c.scan += n;
+            c.head = c.scan;
+            c.bodyLeft -= n;
+            if (c.bodyLeft) return;
+            c.state = P_REQUEST_LINE;
+            continue;
+        }
+
+        const char* nl = (const char*)memchr(c.rx + c.scan, '\n', c.rxLen - c.scan);
+        if (!nl) {
+            if (c.rxLen == HTTP_RX_LEN && c.head == 0) fail(c, 431);
+            return;
+        }
+
+        uint16_t start = c.scan;
+        uint16_t len = nl - (c.rx + start);
+        if (len && c.rx[start + len - 1] == '\r') len--;
+        c.scan = nl - c.rx + 1;
+
+        if (c.state == P_REQUEST_LINE) {
+            if (!len) {
+                c.head = c.scan;   // stray CRLF between requests
+                continue;
+            }
+            if (!parseRequestLine(c, start, len)) {
+                fail(c, 400);
+                return;
+            }
+            c.state = P_HEADERS;
+        } else if (len) {
+            parseHeader(c, start, len);
+        } else {
+            c.state = P_DISPATCH;
+        }
+    }
+}
+
+// METHOD SP target SP HTTP/x.y
+bool HttpEngine::parseRequestLine(Conn& c, uint16_t start, uint16_t len) {
+    const char* line = c.rx + start;
+    const char* sp1 = (const char*)memchr(line, ' ', len);
+    if (!sp1) return false;
+    const char* target = sp1 + 1;
+    const char* sp2 = (const char*)memchr(target, ' ', line + len - target);
+    if (!sp2 || sp2 == target) return false;
+
+    const char* version = sp2 + 1;
+    uint16_t versionLen = line + len - version;
+    if (versionLen != 8 || strncmp(version, "HTTP/1.", 7) != 0) return false;
+
+    c.method = { start, (uint16_t)(sp1 - line) };
+    const char* q = (const char*)memchr(target, '?', sp2 - target);
+    const char* pathEnd = q ? q : sp2;
+    c.path = { (uint16_t)(target - c.rx), (uint16_t)(pathEnd - target) };
+    c.query = q ? Span{ (uint16_t)(q + 1 - c.rx), (uint16_t)(sp2 - q - 1) } : Span{ 0, 0 };
+
+    c.keepAlive = version[7] == '1';   // HTTP/1.1 defaults to keep-alive
+    c.bodyLeft = 0;
+    return true;
+}
+
+// Only the headers that affect framing are looked at
+void HttpEngine::parseHeader(Conn& c, uint16_t start, uint16_t len) {
+    const char* line = c.rx + start;
+    const char* colon = (const char*)memchr(line, ':', len);
+    if (!colon) return;
+
+    uint16_t nameLen = colon - line;
+    const char* value = colon + 1;
+    const char* end = line + len;
+    while (value < end && (*value == ' ' || *value == '\t')) value++;
+    while (end > value && (end[-1] == ' ' || end[-1] == '\t')) end--;
+    uint16_t valueLen = end - value;
+
+    if (sliceEqualsNoCase(line, nameLen, "connection")) {
+        if (sliceEqualsNoCase(value, valueLen, "close")) c.keepAlive = false;
+        else if (sliceEqualsNoCase(value, valueLen, "keep-alive")) c.keepAlive = true;
+    } else if (sliceEqualsNoCase(line, nameLen, "content-length")) {
+        uint32_t n = 0;
+        for (const char* p = value; p < end && isdigit((unsigned char)*p); p++) n = n * 10 + (*p - '0');
+        c.bodyLeft = n;
+    } else if (sliceEqualsNoCase(line, nameLen, "transfer-encoding")) {
+        c.keepAlive = false;   // chunked uploads are not supported
+        c.bodyLeft = UINT32_MAX;
+    }
+}
+
+void HttpEngine::dispatch(Conn& c) {
+    HttpRequest req = { slice(c, c.method), slice(c, c.path), slice(c, c.query), c.keepAlive };
+    HttpResponse res(c.tx, sizeof(c.tx), c.keepAlive);
+
+    if (c.bodyLeft == UINT32_MAX) {
+        res.send(501, "text/plain", "Chunked request bodies are not supported\n");
+    } else {
+        HttpHandler handler = notFound;
+        for (uint8_t i = 0; i < routeCount; i++) {
+            if (req.path.equals(routes[i].path)) {
+                handler = routes[i].handler;
+                break;
+            }
+        }
+        if (handler) handler(req, res);
+        else res.send(404, "text/plain", "Not found\n");
+        if (!res.sent()) res.send(500, "text/plain", "No response\n");
+    }
+
+    counters.requests++;
+    c.txLen = res.used;
+    c.txSent = 0;
+    if (!c.keepAlive) c.closing = true;
+
+    c.head = c.scan;
+    c.state = c.bodyLeft ? P_DISCARD : P_REQUEST_LINE;
+    flush(c);
+}
+
+void HttpEngine::fail(Conn& c, int code) {
+    counters.errors++;
+    HttpResponse res(c.tx, sizeof(c.tx), false);
+    res.send(code, "text/plain", statusText(code));
+    c.txLen = res.used;
+    c.txSent = 0;
+    c.closing = true;
+    flush(c);
+}
+
+void HttpEngine::flush(Conn& c) {
+    if (!c.txLen) return;
+    int n = send(c.fd, c.tx + c.txSent, c.txLen - c.txSent, MSG_DONTWAIT);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) drop(c);
+        return;
+    }
+    c.txSent += n;
+    c.lastActive = millis();
+    if (c.txSent == c.txLen) c.txLen = c.txSent = 0;
+}
+
+// Moves the unparsed tail to the front; spans are shifted along with it
+void HttpEngine::compact(Conn& c) {
+    uint16_t shift = c.head;
+    memmove(c.rx, c.rx + shift, c.rxLen - shift);
+    c.rxLen -= shift;
+    c.scan -= shift;
+    c.head = 0;
+    if (c.state == P_HEADERS || c.state == P_DISPATCH) {
+        c.method.off -= shift;
+        c.path.off -= shift;
+        if (c.query.len) c.query.off -= shift;
+    }
+}
+
+void HttpEngine::drop(Conn& c) {
+    if (c.fd < 0) return;
+    close(c.fd);
+    c.fd = -1;
+    c.txLen = 0;
+    c.closing = true;   // stops a parse loop that is still running
+}
@@ -1,16 +1,46 @@
 /*
   Basic ESP32 Webserver
   Control Built-in LED (GPIO 2)
+  Several browsers can stay connected (keep-alive); see HttpEngine.h
 */
 
 #include <WiFi.h>
+#include "HttpEngine.h"
 
 const char* ssid = "23-1078";
 const char* password = "";
 
-WiFiServer server(80);
+HttpEngine server(80);
 const int LED_PIN = 2;    // Built-in LED
 
+#define STATS_REPORT_MS 30000
+unsigned long lastReport = 0;
+
+// ----- RESPONSE PAGE -----
+static const char htmlPage[] =
+  "<!DOCTYPE html><html>"
+  "<h1>ESP32 LED Control</h1>"
+  "<p><a href=\"/LED=ON\"><button>LED ON</button></a></p>"
+  "<p><a href=\"/LED=OFF\"><button>LED OFF</button></a></p>"
+  "</html>";
+
+void handleRoot(const HttpRequest& req, HttpResponse& res) {
+  res.send(200, "text/html", htmlPage);
+}
+
+// ----- LED CONTROL -----
+void handleLedOn(const HttpRequest& req, HttpResponse& res) {
+  digitalWrite(LED_PIN, HIGH);
+  Serial.println("LED ON");
+  res.send(200, "text/html", htmlPage);
+}
+
+void handleLedOff(const HttpRequest& req, HttpResponse& res) {
+  digitalWrite(LED_PIN, LOW);
+  Serial.println("LED OFF");
+  res.send(200, "text/html", htmlPage);
+}
+
 void setup() {
   Serial.begin(115200);
   pinMode(LED_PIN, OUTPUT);
@@ -30,40 +60,21 @@ void setup() {
   Serial.print("ESP32 IP Address: ");
   Serial.println(WiFi.localIP());
 
-  server.begin();
+  server.on("/", handleRoot);
+  server.on("/LED=ON", handleLedOn);
+  server.on("/LED=OFF", handleLedOff);
+  if (!server.begin()) Serial.println("HTTP server failed to start");
 }
 
 void loop() {
-  WiFiClient client = server.available();
-  if (!client) return;  // No client, exit
-
-  Serial.println("New Client connected");
-  String request = client.readStringUntil('\r');
-  Serial.println(request);
+  // Waits up to 10 ms for any socket, then handles every one that is ready
+  server.poll(10);
 
-  // ----- LED CONTROL -----
-  if (request.indexOf("/LED=ON") != -1) {
-    digitalWrite(LED_PIN, HIGH);
+  if (millis() - lastReport >= STATS_REPORT_MS) {
+    lastReport = millis();
+    const HttpStats& st = server.stats();
+    Serial.printf("HTTP: %u clients (peak %u), %lu requests, %lu connections, %lu errors\n",
+                  server.clients(), st.peakClients, (unsigned long)st.requests,
+                  (unsigned long)st.accepted, (unsigned long)st.errors);
   }
-  if (request.indexOf("/LED=OFF") != -1) {
-    digitalWrite(LED_PIN, LOW);
-  }
-
-  // ----- RESPONSE PAGE -----
-  String htmlPage =
-    "<!DOCTYPE html><html>"
-    "<h1>ESP32 LED Control</h1>"
-    "<p><a href=\"/LED=ON\"><button>LED ON</button></a></p>"
-    "<p><a href=\"/LED=OFF\"><button>LED OFF</button></a></p>"
-    "</html>";
-
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: text/html");
-  client.println("Connection: close");
-  client.println();
-  client.println(htmlPage);
-
-  delay(1);
-  client.stop();
-  Serial.println("Client disconnected");
-}
\ No newline at end of file
+}
@@ -0,0 +1,59 @@
+// Server-Sent Events (text/event-stream) fan-out for WebServer
+// An event is serialised once into a shared byte ring; every listener only
+// owns a read position into it and is fed with non-blocking sends from
+// loop(). A listener that falls more than SSE_BUFFER_LEN bytes behind is
+// disconnected (the browser's EventSource reconnects by itself), so memory
+// is fixed and work follows the number of events, not viewers x polls.
+
+#pragma once
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+#define SSE_MAX_CLIENTS  4
+#define SSE_BUFFER_LEN   1024    // shared backlog; bounds every client's lag
+#define SSE_HEARTBEAT_MS 15000   // comment line that also detects dead peers
+#define SSE_RETRY_MS     3000    // reconnect delay suggested to browsers
+
+struct EventStreamStats {
+    uint32_t events;     // serialised once each
+    uint32_t attached;
+    uint32_t dropped;    // listeners cut off for being too slow
+    uint32_t bytesOut;   // summed over all listeners
+};
+
+class EventStream {
+public:
+    EventStream();
+
+    // From a WebServer handler: takes the connection over and sends the
+    // stream headers. Returns false (nothing sent) when all slots are used.
+    bool attach(WebServer& server);
+
+    // Queues "event: <name>\nid: <id>\ndata: <data>\n\n" for every listener
+    bool publish(const char* name, const char* data, uint32_t id);
+
+    // Sends pending bytes, heartbeats and reaps closed connections
+    void loop();
+
+    uint8_t clients() const;
+    const EventStreamStats& stats() const { return counters; }
+
+private:
+    struct Listener {
+        WiFiClient client;   // holds the socket open after WebServer lets go
+        uint32_t cursor;     // absolute ring position of the next byte to send
+        bool active;
+    };
+
+    void append(const char* data, size_t len);
+    void pump(Listener& l);
+    void drop(Listener& l, bool slow);
+
+    char ring[SSE_BUFFER_LEN];
+    uint32_t head;         // absolute position of the next byte written
+    uint32_t lastEvent;    // start of the latest event; replayed to newcomers
+    uint32_t lastBeat;
+    Listener listeners[SSE_MAX_CLIENTS];
+    EventStreamStats counters;
+};
@@ -0,0 +1,47 @@
+// Allocation-free streamed HTTP responses for WebServer
+// Bodies are written through a small stack buffer and leave as HTTP/1.1
+// chunks of up to HTTP_CHUNK_LEN bytes, so no page is ever assembled in a
+// String. Templates live in flash; "$X" marks a field that is filled in by
+// a callback while streaming (use "$$" for a literal '$').
+//
+// Conditional requests: with a per-content ETag, sendNotModified() answers
+// If-None-Match with an empty 304 before any body work is done.
+
+#pragma once
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+#define HTTP_CHUNK_LEN 256
+
+// Writes the value of template field `key` into out; returns its length
+typedef size_t (*TemplateField)(char key, char* out, size_t len);
+
+class HttpStream {
+public:
+    explicit HttpStream(WebServer& server) : server(server), used(0), total(0) {}
+
+    // Status line + headers; the body follows as chunks
+    void begin(int code, const char* contentType);
+    void write(const char* data, size_t len);
+    void print(const char* s) { write(s, strlen(s)); }
+    // Output longer than HTTP_CHUNK_LEN is formatted on the heap
+    void printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    void writeTemplate(PGM_P tpl, TemplateField field);
+    void end();   // flushes and sends the terminating chunk
+
+    uint32_t bytes() const { return total; }
+
+private:
+    void flush();
+
+    WebServer& server;
+    char buf[HTTP_CHUNK_LEN];
+    size_t used;
+    uint32_t total;
+};
+
+// Adds ETag / Cache-Control and sends a 304 if the client already has
+// this version. Returns true when the request has been answered.
+// Requires server.collectHeaders() to include "If-None-Match".
+bool sendNotModified(WebServer& server, const char* etag);
@@ -0,0 +1,133 @@
+#include "EventStream.h"
+
+#include <lwip/sockets.h>
+#include <errno.h>
+
+// WebServer::client() returns a copy; stopping it leaves WebServer's own
+// handle (and the socket) alone. _currentClient is protected, so it is
+// reached through a derived class and moved out in attach(): handleClient()
+// then finds no client, skips its wait-for-close state and accepts the
+// next request, while the socket stays open in the listener.
+struct WebServerHandover : WebServer {
+    static WiFiClient WebServer::* current() { return &WebServerHandover::_currentClient; }
+};
+
+EventStream::EventStream() : head(0), lastEvent(0), lastBeat(0), counters() {
+    for (Listener& l : listeners) l.active = false;
+}
+
+bool EventStream::attach(WebServer& server) {
+    Listener* slot = nullptr;
+    for (Listener& l : listeners) {
+        if (!l.active) {
+            slot = &l;
+            break;
+        }
+    }
+    if (!slot) return false;
+
+    WiFiClient& current = server.*WebServerHandover::current();
+    slot->client = current;
+    current = WiFiClient();   // WebServer's reference; the listener's keeps the socket
+
+    char hdr[160];
+    int n = snprintf(hdr, sizeof(hdr),
+                     "HTTP/1.1 200 OK\r\n"
+                     "Content-Type: text/event-stream\r\n"
+                     "Cache-Control: no-cache\r\n"
+                     "Connection: keep-alive\r\n\r\n"
+                     "retry: %u\n\n",
+                     SSE_RETRY_MS);
+    if (slot->client.write((const uint8_t*)hdr, n) != (size_t)n) {
+        slot->client.stop();
+        return false;
+    }
+
+    // Start at the latest event still in the ring, so the page is current at once
+    slot->cursor = head - lastEvent <= SSE_BUFFER_LEN ? lastEvent : head;
+    slot->active = true;
+    counters.attached++;
+    pump(*slot);
+    return true;
+}
+
+bool EventStream::publish(const char* name, const char* data, uint32_t id) {
+    char buf[SSE_BUFFER_LEN / 4];
+    int n = snprintf(buf, sizeof(buf), "event: %s\nid: %lu\ndata: %s\n\n",
+                     name, (unsigned long)id, data);
+    if (n < 0 || n >= (int)sizeof(buf)) return false;
+
+    lastEvent = head;
+    append(buf, n);
+    counters.events++;
+    for (Listener& l : listeners) {
+        if (l.active) pump(l);
+    }
+    return true;
+}
+
+void EventStream::append(const char* data, size_t len) {
+    // Anyone this write would overrun is too far behind to catch up
+    for (Listener& l : listeners) {
+        if (l.active && head + len - l.cursor > SSE_BUFFER_LEN) drop(l, true);
+    }
+
+    while (len) {
+        uint32_t off = head % SSE_BUFFER_LEN;
+        size_t n = min(len, (size_t)(SSE_BUFFER_LEN - off));
+        memcpy(ring + off, data, n);
+        head += n;
+        data += n;
+        len -= n;
+    }
+}
+
+void EventStream::loop() {
+    uint32_t now = millis();
+    if (now - lastBeat >= SSE_HEARTBEAT_MS) {
+        lastBeat = now;
+        if (clients()) append(":\n\n", 3);
+
+        // Peers that closed show up as a 0-byte read
+        for (Listener& l : listeners) {
+            if (!l.active) continue;
+            char c;
+            int r = recv(l.client.fd(), &c, 1, MSG_PEEK | MSG_DONTWAIT);
+            if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) drop(l, false);
+        }
+    }
+
+    for (Listener& l : listeners) {
+        if (l.active && l.cursor != head) pump(l);
+    }
+}
+
+// Sends as much of the backlog as the socket takes right now, never waiting
+void EventStream::pump(Listener& l) {
+    while (l.cursor != head) {
+        uint32_t off = l.cursor % SSE_BUFFER_LEN;
+        size_t len = min((size_t)(head - l.cursor), (size_t)(SSE_BUFFER_LEN - off));
+        int n = send(l.client.fd(), ring + off, len, MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) drop(l, false);
+            return;
+        }
+        l.cursor += n;
+        counters.bytesOut += n;
+        if ((size_t)n < len) return;   // socket buffer full
+    }
+}
+
+void EventStream::drop(Listener& l, bool slow) {
+    l.client.stop();
+    l.active = false;
+    if (slow) counters.dropped++;
+}
+
+uint8_t EventStream::clients() const {
+    uint8_t n = 0;
+    for (const Listener& l : listeners) {
+        if (l.active) n++;
+    }
+    return n;
+}
@@ -0,0 +1,92 @@
+#include "HttpStream.h"
+
+void HttpStream::begin(int code, const char* contentType) {
+    used = 0;
+    total = 0;
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);   // -> Transfer-Encoding: chunked
+    server.send(code, contentType, "");
+}
+
+void HttpStream::write(const char* data, size_t len) {
+    while (len) {
+        size_t n = min(len, sizeof(buf) - used);
+        memcpy(buf + used, data, n);
+        used += n;
+        data += n;
+        len -= n;
+        if (used == sizeof(buf)) flush();
+    }
+}
+
+// Formats straight into the chunk buffer; if the text does not fit the
+// space left, it is formatted again after a flush, or on the heap when it
+// is longer than a whole chunk. Never truncated.
+void HttpStream::printf(const char* fmt, ...) {
+    va_list args, again;
+    va_start(args, fmt);
+    va_copy(again, args);
+    int n = vsnprintf(buf + used, sizeof(buf) - used, fmt, args);
+    va_end(args);
+
+    if (n < 0) {
+        log_e("bad format \"%s\"", fmt);
+    } else if ((size_t)n < sizeof(buf) - used) {
+        used += n;
+    } else if ((size_t)n < sizeof(buf)) {
+        flush();
+        vsnprintf(buf, sizeof(buf), fmt, again);
+        used = n;
+    } else {
+        char* tmp = (char*)malloc(n + 1);
+        if (tmp) {
+            vsnprintf(tmp, n + 1, fmt, again);
+            write(tmp, n);
+            free(tmp);
+        } else {
+            log_e("%d bytes lost, no memory", n);
+        }
+    }
+    va_end(again);
+}
+
+// Literal runs are copied straight from flash; only fields are formatted
+void HttpStream::writeTemplate(PGM_P tpl, TemplateField field) {
+    PGM_P run = tpl;
+    for (PGM_P p = tpl; ; p++) {
+        char c = pgm_read_byte(p);
+        if (c != '$' && c != '\0') continue;
+
+        write(run, p - run);
+        if (c == '\0') break;
+
+        char key = pgm_read_byte(++p);
+        if (key == '\0') break;
+        if (key == '$') {
+            write("$", 1);
+        } else {
+            char value[48];
+            write(value, min(field(key, value, sizeof(value)), sizeof(value) - 1));
+        }
+        run = p + 1;
+    }
+}
+
+void HttpStream::flush() {
+    if (!used) return;
+    server.sendContent(buf, used);
+    total += used;
+    used = 0;
+}
+
+void HttpStream::end() {
+    flush();
+    server.sendContent(buf, 0);   // zero-length chunk ends the body
+}
+
+bool sendNotModified(WebServer& server, const char* etag) {
+    server.sendHeader("ETag", etag);
+    server.sendHeader("Cache-Control", "no-cache");   // always revalidate, cheap when unchanged
+    if (!server.hasHeader("If-None-Match") || server.header("If-None-Match") != etag) return false;
+    server.send(304);
+    return true;
+}
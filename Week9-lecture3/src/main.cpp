@@ -4,111 +4,191 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
-#include "DHT.h"
+#include <PagedSSD1306.h>
+#include <RmtDHT.h>
+#include <ButtonEvents.h>
+#include <SensorSources.h>
+#include <TimeSeries.h>
+#include "HttpStream.h"
+#include "EventStream.h"
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+PagedSSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
 
 // Pins
 #define DHTPIN 23
 #define DHTTYPE DHT11
 #define BUTTON_PIN 5   // Button to GND, use INPUT_PULLUP
 
-DHT dht(DHTPIN, DHTTYPE);
+RmtDHT dht(DHTPIN, DHTTYPE);   // sampled in the background, button = extra read
+#define HISTORY_SAMPLE_MS 10000  // periodic DHT reads feeding the history
 
 // WiFi credentials
 const char* ssid     = "23-1078";
 const char* password = "";
 
 WebServer server(80);
+EventStream events;   // /events: every new sample is pushed to open pages
 
 // Last measured values
 float lastTemp = NAN;
 float lastHum  = NAN;
 
-bool lastButtonState = HIGH;
-
-// --- Helper: read DHT and update globals ---
-void readDHTValues() {
-  float h = dht.readHumidity();
-  float t = dht.readTemperature(); // Celsius
-
-  if (!isnan(h) && !isnan(t)) {
-    lastHum  = h;
-    lastTemp = t;
-    Serial.print("Temp: ");
-    Serial.print(t);
-    Serial.print(" *C, Humidity: ");
-    Serial.print(h);
-    Serial.println(" %");
-  } else {
-    Serial.println("Failed to read from DHT!");
-  }
+// Bumped on every good sample; part of each response's ETag together with
+// a per-boot id, so a browser's cached copy never survives a reboot
+uint32_t bootId = 0;
+uint32_t dataVersion = 0;
+char etag[24];
+
+void updateEtag() {
+  snprintf(etag, sizeof(etag), "\"%08lx-%lu\"", (unsigned long)bootId, (unsigned long)dataVersion);
 }
 
-// --- Helper: show values on OLED ---
-void showOnOLED() {
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(WHITE);
+// History: last 60 samples, 60 x 1-minute and 24 x 1-hour min/max/avg
+// (seconds since boot; 2 x 2164 bytes = ~4.3 KB total, fixed; printed at boot)
+TimeSeries<60> tempHistory;
+TimeSeries<60> humHistory;
+
+ButtonEvents buttons;   // debounced by interrupt + timer, see loop()
+
+// --- Helper: take a valid sample into the globals, history and /events ---
+void applyDHTSample(const SensorFrame& f) {
+  float h = f.humidity;
+  float t = f.temperature; // Celsius
+
+  lastHum  = h;
+  lastTemp = t;
+  tempHistory.add(f.timestamp / 1000, t);
+  humHistory.add(f.timestamp / 1000, h);
+  dataVersion++;
+  updateEtag();
+
+  char json[64];
+  snprintf(json, sizeof(json), "{\"temp\":%.1f,\"hum\":%.1f,\"t\":%lu}",
+           t, h, (unsigned long)(f.timestamp / 1000));
+  events.publish("sample", json, dataVersion);
+}
 
-  if (isnan(lastTemp) || isnan(lastHum)) {
-    display.setCursor(0, 0);
-    display.println("DHT Error!");
-  } else {
-    display.setCursor(0, 0);
-    display.println("DHT22 Readings");
-
-    display.setCursor(0, 20);
-    display.print("Temp: ");
-    display.print(lastTemp, 1);
-    display.println(" C");
-
-    display.setCursor(0, 40);
-    display.print("Hum:  ");
-    display.print(lastHum, 1);
-    display.println(" %");
+// --- Node: DHT -> Serial + OLED, valid samples -> web state ---
+auto node = makePipeline(dhtSource(dht), printSink(Serial),
+                         oledSink(display, "DHT22 Readings"),
+                         requireFields(FRAME_TEMP | FRAME_HUM),
+                         callSink(applyDHTSample));
+
+// --- Web handlers ---
+// Page template in flash. Fields: $T temperature, $H humidity, $R last-hour
+// range line. Readings are updated in place from /events; without
+// JavaScript the page falls back to reloading every 5 s.
+static const char PAGE[] PROGMEM =
+  "<!DOCTYPE html><html><head><meta charset='UTF-8'>"
+  "<meta name='viewport' content='width=device-width, initial-scale=1'>"
+  "<noscript><meta http-equiv='refresh' content='5'></noscript>"
+  "<title>ESP32 DHT Monitor</title></head><body>"
+  "<h2>ESP32 DHT22 Readings</h2>"
+  "<p><b>Temperature:</b> <span id='t'>$T</span> &deg;C</p>"
+  "<p><b>Humidity:</b> <span id='h'>$H</span> %</p>"
+  "$R"
+  "<hr><p>Press the physical button to update readings on OLED and here.</p>"
+  "<script>"
+  "new EventSource('/events').addEventListener('sample',function(e){"
+  "var d=JSON.parse(e.data);"
+  "document.getElementById('t').textContent=d.temp.toFixed(1);"
+  "document.getElementById('h').textContent=d.hum.toFixed(1);});"
+  "</script>"
+  "</body></html>";
+
+HttpStream http(server);
+
+size_t pageField(char key, char* out, size_t len) {
+  uint32_t now = millis() / 1000;
+  switch (key) {
+    case 'T': return isnan(lastTemp) ? snprintf(out, len, "--") : snprintf(out, len, "%.1f", lastTemp);
+    case 'H': return isnan(lastHum) ? snprintf(out, len, "--") : snprintf(out, len, "%.1f", lastHum);
+    case 'R': {
+      TsAggregate hourT = tempHistory.summary(TS_MINUTE, now - min<uint32_t>(now, 3599), now);
+      if (!hourT.count) return 0;
+      // Written directly: the line is longer than a field buffer
+      http.printf("<p>Last hour: %.1f &ndash; %.1f", hourT.min, hourT.max);
+      http.printf(" &deg;C (avg %.1f)</p>", hourT.avg());
+      return 0;
+    }
+    default:
+      return 0;
   }
-
-  display.display();
 }
 
-// --- Web handler ---
 void handleRoot() {
   // Option A: use last measured values
-  // Option B: take fresh reading here, uncomment if you want:
-  // readDHTValues();
+  // Option B: request a fresh reading here (pushed to the page via /events):
+  // dht.trigger();
 
-  String html = "<!DOCTYPE html><html><head><meta charset='UTF-8'>";
-  html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-  html += "<meta http-equiv='refresh' content='5'>";
-  html += "<title>ESP32 DHT Monitor</title></head><body>";
-  html += "<h2>ESP32 DHT22 Readings</h2>";
+  // Reloads revalidate; unchanged data costs a 304
+  if (sendNotModified(server, etag)) return;
 
-  if (isnan(lastTemp) || isnan(lastHum)) {
-    html += "<p><b>No valid data yet.</b><br>Press the button to take a reading.</p>";
+  http.begin(200, "text/html");
+  http.writeTemplate(PAGE, pageField);
+  http.end();
+}
+
+// --- /api/latest: the current sample as compact JSON ---
+void handleLatest() {
+  if (sendNotModified(server, etag)) return;
+
+  const TsSample* t = tempHistory.latest();
+  const TsSample* h = humHistory.latest();
+  http.begin(200, "application/json");
+  if (t && h) {
+    http.printf("{\"temp\":%.1f,\"hum\":%.1f,", t->value, h->value);
+    http.printf("\"t\":%lu,\"seq\":%lu}", (unsigned long)t->t, (unsigned long)dataVersion);
   } else {
-    html += "<p><b>Temperature:</b> ";
-    html += String(lastTemp, 1);
-    html += " &deg;C</p>";
+    http.print("{}");
+  }
+  http.end();
+}
 
-    html += "<p><b>Humidity:</b> ";
-    html += String(lastHum, 1);
-    html += " %</p>";
+// --- /events: SSE stream of "sample" events ---
+void handleEvents() {
+  if (!events.attach(server)) {
+    server.send(503, "text/plain", "Too many live viewers, try again later\n");
   }
+}
 
-  html += "<hr><p>Press the physical button to update readings on OLED and here.</p>";
-  html += "</body></html>";
+// --- /api/history[?tier=hour]: [start, min, avg, max] per bucket ---
+void streamBuckets(const char* name, const TimeSeries<60>& series, TsTier tier, uint32_t now) {
+  http.printf("\"%s\":[", name);
+  bool first = true;
+  uint32_t span = TimeSeries<60>::width(tier) * TimeSeries<60>::capacity(tier);
+  series.range(tier, now - min(now, span - 1), now, [&](const TsAggregate& a) {
+    http.printf("%s[%lu,%.1f,%.1f,%.1f]", first ? "" : ",",
+                (unsigned long)a.start, a.min, a.avg(), a.max);
+    first = false;
+  });
+  http.print("]");
+}
+
+void handleHistory() {
+  if (sendNotModified(server, etag)) return;
+
+  TsTier tier = server.arg("tier") == "hour" ? TS_HOUR : TS_MINUTE;
+  uint32_t now = millis() / 1000;
 
-  server.send(200, "text/html", html);
+  http.begin(200, "application/json");
+  http.print("{");
+  streamBuckets("temp", tempHistory, tier, now);
+  http.print(",");
+  streamBuckets("hum", humHistory, tier, now);
+  http.print("}");
+  http.end();
 }
 
 void setup() {
   Serial.begin(115200);
+  Serial.printf("History: %u bytes\n", (unsigned)(sizeof(tempHistory) + sizeof(humHistory)));
 
-  pinMode(BUTTON_PIN, INPUT_PULLUP);
+  buttons.add(BUTTON_PIN);
+  buttons.begin();
 
   // OLED init
   if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
@@ -123,7 +203,7 @@ void setup() {
   display.println("Booting...");
   display.display();
 
-  dht.begin();
+  dht.begin(HISTORY_SAMPLE_MS);
 
   // WiFi connect
   WiFi.begin(ssid, password);
@@ -153,25 +233,31 @@ void setup() {
   display.display();
 
   // Web server
+  bootId = esp_random();
+  updateEtag();
+
+  static const char* conditionalHeaders[] = { "If-None-Match" };
+  server.collectHeaders(conditionalHeaders, 1);
   server.on("/", handleRoot);
+  server.on("/api/latest", handleLatest);
+  server.on("/api/history", handleHistory);
+  server.on("/events", handleEvents);
   server.begin();
 }
 
 void loop() {
   server.handleClient();
+  events.loop();
 
-  bool currentButtonState = digitalRead(BUTTON_PIN);
+  // Periodic and triggered reads complete in the background
+  node.step();
 
-  // Detect falling edge (HIGH -> LOW)
-  if (lastButtonState == HIGH && currentButtonState == LOW) {
-    // Small debounce delay
-    delay(50);
-    if (digitalRead(BUTTON_PIN) == LOW) {
+  // Presses queue up even while a page is being served
+  ButtonEvent e;
+  while (buttons.read(e)) {
+    if (e.type == BTN_PRESS) {
       Serial.println("Button pressed: reading DHT + updating OLED");
-      readDHTValues();
-      showOnOLED();
+      dht.trigger();
     }
   }
-
-  lastButtonState = currentButtonState;
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "ButtonEvents.h"
+#include <esp_timer.h>
+
+ButtonEvents::ButtonEvents() : count(0), queue(nullptr), timer(nullptr), numOverflows(0) {}
+
+int8_t ButtonEvents::add(uint8_t pin, uint16_t doubleClickMs, bool activeLow) {
+    if (count >= BTN_MAX || queue) return -1;
+    Button& b = buttons[count];
+    b.pin = pin;
+    b.activeLow = activeLow;
+    b.doubleClickMs = doubleClickMs;
+    b.edge = false;
+    b.edgeUs = 0;
+    b.pressed = false;
+    b.longSent = false;
+    b.clicks = 0;
+    b.pressedAt = b.releasedAt = 0;
+    args[count] = { this, count };
+    return count++;
+}
+
+bool ButtonEvents::begin() {
+    queue = xQueueCreate(BTN_QUEUE_LEN, sizeof(ButtonEvent));
+    if (!queue) return false;
+    timer = xTimerCreate("btn", pdMS_TO_TICKS(BTN_DEBOUNCE_MS), pdFALSE, this, onTimer);
+    if (!timer) return false;
+
+    for (uint8_t i = 0; i < count; i++) {
+        Button& b = buttons[i];
+        pinMode(b.pin, b.activeLow ? INPUT_PULLUP : INPUT_PULLDOWN);
+        b.pressed = (digitalRead(b.pin) == LOW) == b.activeLow;   // held at boot: no event
+        attachInterruptArg(digitalPinToInterrupt(b.pin), onEdge, &args[i], CHANGE);
+    }
+    return true;
+}
+
+bool ButtonEvents::read(ButtonEvent& out) {
+    return queue && xQueueReceive(queue, &out, 0) == pdTRUE;
+}
+
+const char* ButtonEvents::typeName(ButtonEventType t) {
+    switch (t) {
+        case BTN_PRESS:   return "press";
+        case BTN_RELEASE: return "release";
+        case BTN_SHORT:   return "short";
+        case BTN_LONG:    return "long";
+        case BTN_DOUBLE:  return "double";
+        default:          return "?";
+    }
+}
+
+// Bounces keep pushing the settle point out; only the first edge is kept
+void IRAM_ATTR ButtonEvents::onEdge(void* arg) {
+    IsrArg* a = static_cast<IsrArg*>(arg);
+    Button& b = a->self->buttons[a->index];
+    if (!b.edge) {
+        b.edgeUs = esp_timer_get_time();
+        b.edge = true;
+    }
+    // Restarts the timer with the debounce period, replacing any deadline
+    // it was armed for; settle() recomputes those
+    BaseType_t woken = pdFALSE;
+    xTimerChangePeriodFromISR(a->self->timer, pdMS_TO_TICKS(BTN_DEBOUNCE_MS), &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+void ButtonEvents::onTimer(TimerHandle_t timer) {
+    static_cast<ButtonEvents*>(pvTimerGetTimerID(timer))->settle();
+}
+
+// Runs in the FreeRTOS timer task: after a quiet debounce period, or at the
+// next long-press / double-click deadline
+void ButtonEvents::settle() {
+    uint32_t now = millis();
+    uint32_t next = UINT32_MAX;   // ms until the nearest deadline
+
+    for (uint8_t i = 0; i < count; i++) {
+        Button& b = buttons[i];
+
+        if (b.edge) {
+            uint32_t at = (uint32_t)(b.edgeUs / 1000);
+            b.edge = false;
+            bool down = (digitalRead(b.pin) == LOW) == b.activeLow;
+            if (down && !b.pressed) {
+                b.pressed = true;
+                b.longSent = false;
+                b.pressedAt = at;
+                emit(i, BTN_PRESS, at, 0);
+            } else if (!down && b.pressed) {
+                b.pressed = false;
+                b.releasedAt = at;
+                uint32_t held = at - b.pressedAt;
+                emit(i, BTN_RELEASE, at, held);
+                if (!b.longSent) {
+                    if (!b.doubleClickMs) {
+                        emit(i, BTN_SHORT, at, held);
+                    } else if (++b.clicks == 2) {
+                        b.clicks = 0;
+                        emit(i, BTN_DOUBLE, at, held);
+                    }
+                }
+            }
+        }
+
+        if (b.pressed && !b.longSent) {
+            uint32_t held = now - b.pressedAt;
+            if (held >= BTN_LONG_MS) {
+                b.longSent = true;
+                b.clicks = 0;
+                emit(i, BTN_LONG, now, held);
+            } else {
+                next = min<uint32_t>(next, BTN_LONG_MS - held);
+            }
+        }
+
+        if (!b.pressed && b.clicks == 1) {
+            uint32_t idle = now - b.releasedAt;
+            if (idle >= b.doubleClickMs) {
+                b.clicks = 0;
+                emit(i, BTN_SHORT, b.releasedAt, b.releasedAt - b.pressedAt);
+            } else {
+                next = min<uint32_t>(next, b.doubleClickMs - idle);
+            }
+        }
+    }
+
+    if (next != UINT32_MAX) {
+        xTimerChangePeriod(timer, pdMS_TO_TICKS(max<uint32_t>(next, 1)), 0);
+    }
+}
+
+void ButtonEvents::emit(uint8_t button, ButtonEventType type, uint32_t at, uint32_t duration) {
+    ButtonEvent e = { button, type, at, duration };
+    if (xQueueSend(queue, &e, 0) != pdTRUE) numOverflows++;
+}
@@ -0,0 +1,89 @@
+// Interrupt-driven push buttons with debouncing and gesture events
+// Every edge raises a GPIO interrupt whose IRAM handler only timestamps it
+// and (re)arms a one-shot FreeRTOS timer. When the line has been quiet for
+// BTN_DEBOUNCE_MS the timer callback reads the settled levels and turns
+// them into events; the same timer is re-armed for long-press and
+// double-click deadlines, so nothing polls while the buttons are idle.
+//
+// Events wait in a queue until loop() calls read(), which never blocks -
+// a loop() that is busy for a while still sees every press, in order.
+
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/queue.h>
+#include <freertos/timers.h>
+
+#define BTN_MAX           4
+#define BTN_QUEUE_LEN     16
+#define BTN_DEBOUNCE_MS   25
+#define BTN_LONG_MS       1500    // held this long -> BTN_LONG while still down
+
+enum ButtonEventType : uint8_t {
+    BTN_PRESS = 0,    // settled down
+    BTN_RELEASE,      // settled up; duration = time held
+    BTN_SHORT,        // released before BTN_LONG_MS (and no second click followed)
+    BTN_LONG,         // still held after BTN_LONG_MS
+    BTN_DOUBLE        // second short click within the button's double-click window
+};
+
+struct ButtonEvent {
+    uint8_t button;        // index returned by add()
+    ButtonEventType type;
+    uint32_t at;           // millis() of the first edge of the gesture's last change
+    uint32_t duration;     // ms held (RELEASE, SHORT, LONG)
+};
+
+class ButtonEvents {
+public:
+    ButtonEvents();
+
+    // Registers a button (before begin()). With doubleClickMs > 0 a short
+    // click is reported only once that window passed without a second
+    // one; with 0 BTN_SHORT follows the release at once. Returns the index
+    // used in events, or -1 if all slots are taken.
+    int8_t add(uint8_t pin, uint16_t doubleClickMs = 0, bool activeLow = true);
+
+    // Configures the pins, the timer and the interrupts
+    bool begin();
+
+    // Next event, false if none is waiting. Never blocks.
+    bool read(ButtonEvent& out);
+
+    bool isPressed(uint8_t button) const { return button < count && buttons[button].pressed; }
+    uint32_t overflows() const { return numOverflows; }   // events lost to a full queue
+
+    static const char* typeName(ButtonEventType t);
+
+private:
+    struct Button {
+        uint8_t pin;
+        bool activeLow;
+        uint16_t doubleClickMs;
+
+        volatile bool edge;        // set by the ISR, cleared when settled
+        volatile int64_t edgeUs;   // first edge since the last settle
+
+        bool pressed;      // debounced state
+        bool longSent;
+        uint8_t clicks;    // short clicks waiting for a possible second
+        uint32_t pressedAt;
+        uint32_t releasedAt;
+    };
+
+    static void IRAM_ATTR onEdge(void* arg);
+    static void onTimer(TimerHandle_t timer);
+    void settle();
+    void emit(uint8_t button, ButtonEventType type, uint32_t at, uint32_t duration);
+
+    Button buttons[BTN_MAX];
+    uint8_t count;
+    QueueHandle_t queue;
+    TimerHandle_t timer;
+    volatile uint32_t numOverflows;
+
+    struct IsrArg {
+        ButtonEvents* self;
+        uint8_t index;
+    } args[BTN_MAX];
+};
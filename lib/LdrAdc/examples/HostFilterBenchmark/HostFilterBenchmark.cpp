@@ -0,0 +1,101 @@
+// Host throughput benchmark for the LDR filter kernel (not an Arduino sketch)
+//
+//   g++ -O2 -std=c++11 -I../../src HostFilterBenchmark.cpp -o bench && ./bench
+//
+// Feeds a synthetic LDR signal (DC level + 100 Hz mains flicker + noise) at
+// 20 kHz through:
+//   float    - the sketches' old per-sample (adc / 4095.0) * 3.3 conversion
+//   fixed    - AdcDecimator + AdcCalibration, as run by LdrAdc on the ESP32
+// and reports samples per second and the noise left in the output.
+
+#include <AdcFilter.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const uint32_t SAMPLE_RATE = 20000;
+static const uint32_t OUTPUT_HZ = 10;
+static const size_t SAMPLES = 1 << 24;   // ~14 min of signal
+static const int REPEAT = 5;
+
+static double stddev(const std::vector<double>& v) {
+    if (v.size() < 2) return 0;
+    double mean = 0, sq = 0;
+    for (double x : v) mean += x;
+    mean /= v.size();
+    for (double x : v) sq += (x - mean) * (x - mean);
+    return std::sqrt(sq / (v.size() - 1));
+}
+
+template <typename F>
+static double bestSeconds(F fn) {
+    double best = 1e9;
+    for (int r = 0; r < REPEAT; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+int main() {
+    // I2S ADC words: channel 6 in the top nibble, 12-bit sample below
+    std::vector<uint16_t> input(SAMPLES);
+    srand(1);
+    for (size_t i = 0; i < SAMPLES; i++) {
+        double t = (double)i / SAMPLE_RATE;
+        double v = 2000 + 120 * std::sin(2 * M_PI * 100 * t) + (rand() % 81 - 40);
+        input[i] = (6 << 12) | (uint16_t)std::lround(std::fmin(std::fmax(v, 0), 4095));
+    }
+
+    LdrModel model = LDR_MODEL_DEFAULT;
+    AdcCalibration cal;
+    cal.buildLinear(3300, model);
+
+    // Old path: every sample converted to float volts
+    volatile float sinkF = 0;
+    double floatS = bestSeconds([&] {
+        float acc = 0;
+        for (size_t i = 0; i < SAMPLES; i++) acc += ((input[i] & ADC_RAW_MASK) / 4095.0) * 3.3;
+        sinkF = acc;
+    });
+    std::vector<double> rawMv;
+    for (size_t i = 0; i < SAMPLES; i += SAMPLE_RATE / OUTPUT_HZ) {
+        rawMv.push_back(((input[i] & ADC_RAW_MASK) / 4095.0) * 3300);
+    }
+
+    // New path: decimating fixed-point filter + table lookup per output
+    AdcDecimator filter(SAMPLE_RATE / OUTPUT_HZ);
+    volatile uint32_t sinkU = 0;
+    size_t outputs = 0;
+    double fixedS = bestSeconds([&] {
+        filter.reset();
+        uint32_t acc = 0;
+        outputs = filter.process(input.data(), SAMPLES, [&](uint16_t q) {
+            acc += cal.millivolts(q) + cal.deciLuxAt(q);
+        });
+        sinkU = acc;
+    });
+    std::vector<double> filteredMv;
+    uint16_t lastQ = 0;
+    filter.reset();
+    filter.process(input.data(), SAMPLES, [&](uint16_t q) {
+        filteredMv.push_back(cal.millivolts(q));
+        lastQ = q;
+    });
+
+    printf("%zu samples at %u Hz -> %u Hz output (decimation %u)\n",
+           SAMPLES, SAMPLE_RATE, OUTPUT_HZ, filter.factor());
+    printf("  float per sample : %7.1f Msamples/s\n", SAMPLES / floatS / 1e6);
+    printf("  fixed decimator  : %7.1f Msamples/s (%zu outputs)  %.2fx\n",
+           SAMPLES / fixedS / 1e6, outputs, floatS / fixedS);
+    printf("  output noise     : raw %.1f mV sd, filtered %.2f mV sd\n", stddev(rawMv), stddev(filteredMv));
+    printf("  last reading     : %u mV, %.1f lux\n", cal.millivolts(lastQ), cal.deciLuxAt(lastQ) / 10.0);
+    (void)sinkF;
+    (void)sinkU;
+    return 0;
+}
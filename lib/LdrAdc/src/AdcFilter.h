@@ -0,0 +1,137 @@
+// Fixed-point ADC filter kernel and calibration table
+// Plain C++ with no Arduino dependencies, so the same code runs on the ESP32
+// and in the host benchmark (examples/HostFilterBenchmark).
+//
+// AdcDecimator is a decimating moving average: it sums `factor` raw samples
+// and emits one result with ADC_FILTER_FRAC_BITS extra bits of resolution.
+// Per input sample that is a mask, an add and a compare; the division is a
+// multiply by a precomputed reciprocal once per output. A window that spans
+// whole mains cycles (e.g. 100 ms = 5 x 20 ms = 6 x 16.7 ms) also cancels
+// the 100/120 Hz flicker of artificial light on the LDR.
+//
+// AdcCalibration maps the filtered counts to millivolts and lux through a
+// table with one breakpoint every ADC_CAL_STEP counts, filled once at
+// startup (the only place floating point is used), then linearly
+// interpolated in integer arithmetic.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#define ADC_FILTER_FRAC_BITS  4          // output is counts << 4
+#define ADC_RAW_BITS          12
+#define ADC_RAW_MASK          0x0FFF     // I2S ADC words carry the channel in bits 12-15
+#define ADC_CAL_SHIFT         7
+#define ADC_CAL_STEP          (1 << ADC_CAL_SHIFT)                      // 128 counts
+#define ADC_CAL_POINTS        ((1 << ADC_RAW_BITS) / ADC_CAL_STEP + 1)  // 33
+#define ADC_LUX_MAX           100000UL   // clamp for a saturated divider
+
+class AdcDecimator {
+public:
+    explicit AdcDecimator(uint32_t factor = 1) { setFactor(factor); }
+
+    void setFactor(uint32_t factor) {
+        n = factor ? factor : 1;
+        recip = ((uint64_t)1 << (32 + ADC_FILTER_FRAC_BITS)) / n;
+        reset();
+    }
+    uint32_t factor() const { return n; }
+    void reset() { sum = 0; count = 0; }
+
+    // Feeds raw I2S/ADC words; calls emit(value) for every completed window.
+    // Returns the number of outputs produced.
+    template <typename Emit>
+    size_t process(const uint16_t* in, size_t len, Emit emit) {
+        size_t outputs = 0;
+        uint32_t s = sum, c = count;
+        for (size_t i = 0; i < len; i++) {
+            s += in[i] & ADC_RAW_MASK;
+            if (++c == n) {
+                emit(scale(s));
+                outputs++;
+                s = 0;
+                c = 0;
+            }
+        }
+        sum = s;
+        count = c;
+        return outputs;
+    }
+
+private:
+    // sum / n in Q(ADC_FILTER_FRAC_BITS), rounded
+    uint16_t scale(uint32_t s) const {
+        uint32_t q = (uint32_t)((s * recip + ((uint64_t)1 << 31)) >> 32);
+        return q > 0xFFFF ? 0xFFFF : q;
+    }
+
+    uint32_t n;
+    uint64_t recip;   // 2^(32+FRAC) / n
+    uint32_t sum;
+    uint32_t count;
+};
+
+// LDR in a voltage divider. Resistance follows the usual photoresistor
+// model R = R10 * (10 / lux)^gamma (R10 = resistance at 10 lux).
+struct LdrModel {
+    uint32_t supplyMv;       // divider supply
+    uint32_t fixedOhms;      // the other divider resistor
+    bool ldrOnHighSide;      // LDR between supply and pin: brighter = higher voltage
+    uint32_t r10Ohms;
+    float gamma;
+};
+
+#define LDR_MODEL_DEFAULT { 3300, 10000, true, 50000, 0.7f }
+
+class AdcCalibration {
+public:
+    // millivolts[i] is the calibrated voltage at raw count i * ADC_CAL_STEP
+    // (the last point is one past full scale)
+    void build(const uint16_t millivolts[ADC_CAL_POINTS], const LdrModel& model) {
+        for (uint8_t i = 0; i < ADC_CAL_POINTS; i++) {
+            mv[i] = millivolts[i];
+            deciLux[i] = luxAt(millivolts[i], model) * 10.0f + 0.5f;
+        }
+    }
+
+    // Ideal converter: 0..supplyMv linear, for the host or an uncalibrated chip
+    void buildLinear(uint32_t fullScaleMv, const LdrModel& model) {
+        uint16_t table[ADC_CAL_POINTS];
+        for (uint8_t i = 0; i < ADC_CAL_POINTS; i++) {
+            uint32_t v = (uint32_t)i * ADC_CAL_STEP * fullScaleMv >> ADC_RAW_BITS;
+            table[i] = v > fullScaleMv ? fullScaleMv : v;
+        }
+        build(table, model);
+    }
+
+    // `q` is a filtered value in Q(ADC_FILTER_FRAC_BITS) counts
+    uint16_t millivolts(uint16_t q) const { return interpolate(mv, q); }
+    uint32_t deciLuxAt(uint16_t q) const { return interpolate(deciLux, q); }
+
+private:
+    static float luxAt(uint32_t v, const LdrModel& m) {
+        if (v == 0 || v >= m.supplyMv) {
+            bool dark = m.ldrOnHighSide ? v == 0 : v >= m.supplyMv;
+            return dark ? 0.0f : ADC_LUX_MAX;
+        }
+        float ratio = (float)v / (float)(m.supplyMv - v);
+        float r = m.ldrOnHighSide ? m.fixedOhms / ratio : m.fixedOhms * ratio;
+        float lux = 10.0f * powf((float)m.r10Ohms / r, 1.0f / m.gamma);
+        return lux > ADC_LUX_MAX ? ADC_LUX_MAX : lux;
+    }
+
+    template <typename T>
+    static T interpolate(const T* table, uint16_t q) {
+        const uint8_t shift = ADC_CAL_SHIFT + ADC_FILTER_FRAC_BITS;
+        uint32_t i = q >> shift;
+        uint32_t frac = q & ((1u << shift) - 1);
+        if (i >= ADC_CAL_POINTS - 1) return table[ADC_CAL_POINTS - 1];
+        int64_t a = table[i], b = table[i + 1];
+        return (T)(a + (((b - a) * (int64_t)frac) >> shift));
+    }
+
+    uint16_t mv[ADC_CAL_POINTS];
+    uint32_t deciLux[ADC_CAL_POINTS];
+};
@@ -0,0 +1,103 @@
+#include "LdrAdc.h"
+#include <driver/i2s.h>
+#include <esp_adc_cal.h>
+
+#define LDR_I2S_PORT      I2S_NUM_0   // the only I2S unit wired to the ADC
+#define LDR_DEFAULT_VREF  1100        // mV, used when eFuse has no Vref
+
+LdrAdc::LdrAdc(adc1_channel_t channel, uint32_t sampleRate, const LdrModel& model)
+    : channel(channel), sampleRate(sampleRate), model(model), pendingFactor(0),
+      queue(nullptr), task(nullptr), lock(portMUX_INITIALIZER_UNLOCKED),
+      numSamples(0), numReadings(0) {
+    latest = { 0, 0, 0, 0 };
+}
+
+bool LdrAdc::begin(uint16_t outputHz) {
+    // Calibration table from the chip's eFuse characterisation
+    esp_adc_cal_characteristics_t chars;
+    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, LDR_DEFAULT_VREF, &chars);
+    uint16_t table[ADC_CAL_POINTS];
+    for (uint8_t i = 0; i < ADC_CAL_POINTS; i++) {
+        uint32_t raw = min<uint32_t>((uint32_t)i * ADC_CAL_STEP, ADC_RAW_MASK);
+        table[i] = esp_adc_cal_raw_to_voltage(raw, &chars);
+    }
+    calibration.build(table, model);
+
+    setOutputRate(outputHz);
+    filter.setFactor(pendingFactor);
+    pendingFactor = 0;
+
+    i2s_config_t config = {};
+    config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    config.sample_rate = sampleRate;
+    config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    config.communication_format = I2S_COMM_FORMAT_STAND_MSB;
+    config.dma_buf_count = LDR_DMA_BUF_COUNT;
+    config.dma_buf_len = LDR_DMA_BUF_LEN;
+    if (i2s_driver_install(LDR_I2S_PORT, &config, 0, nullptr) != ESP_OK) return false;
+
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten(channel, ADC_ATTEN_DB_11);
+    i2s_set_adc_mode(ADC_UNIT_1, channel);
+    if (i2s_adc_enable(LDR_I2S_PORT) != ESP_OK) return false;
+
+    queue = xQueueCreate(LDR_QUEUE_LEN, sizeof(LdrReading));
+    if (!queue) return false;
+    return xTaskCreate(taskEntry, "ldr", LDR_TASK_STACK, this, LDR_TASK_PRIORITY, &task) == pdPASS;
+}
+
+void LdrAdc::setOutputRate(uint16_t outputHz) {
+    pendingFactor = max<uint32_t>(sampleRate / max<uint16_t>(outputHz, 1), 1);
+}
+
+bool LdrAdc::read(LdrReading& out) {
+    return queue && xQueueReceive(queue, &out, 0) == pdTRUE;
+}
+
+LdrReading LdrAdc::last() const {
+    portENTER_CRITICAL(&lock);
+    LdrReading r = latest;
+    portEXIT_CRITICAL(&lock);
+    return r;
+}
+
+void LdrAdc::taskEntry(void* arg) {
+    static_cast<LdrAdc*>(arg)->run();
+}
+
+void LdrAdc::emit(uint16_t filtered) {
+    LdrReading r;
+    r.filtered = filtered;
+    r.millivolts = calibration.millivolts(filtered);
+    r.deciLux = calibration.deciLuxAt(filtered);
+    r.timestamp = millis();
+
+    portENTER_CRITICAL(&lock);
+    latest = r;
+    portEXIT_CRITICAL(&lock);
+    numReadings++;
+
+    if (xQueueSend(queue, &r, 0) != pdTRUE) {
+        LdrReading dropped;
+        xQueueReceive(queue, &dropped, 0);   // keep the newest
+        xQueueSend(queue, &r, 0);
+    }
+}
+
+void LdrAdc::run() {
+    static uint16_t buf[LDR_DMA_BUF_LEN];
+    for (;;) {
+        // Blocks until the DMA engine has filled a buffer
+        size_t bytes = 0;
+        if (i2s_read(LDR_I2S_PORT, buf, sizeof(buf), &bytes, portMAX_DELAY) != ESP_OK) continue;
+
+        if (pendingFactor) {
+            filter.setFactor(pendingFactor);
+            pendingFactor = 0;
+        }
+        size_t n = bytes / sizeof(buf[0]);
+        numSamples += n;
+        filter.process(buf, n, [this](uint16_t q) { emit(q); });
+    }
+}
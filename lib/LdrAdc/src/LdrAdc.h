@@ -0,0 +1,67 @@
+// Continuous DMA sampling of an LDR on ADC1
+// On the classic ESP32 the ADC's continuous mode runs through I2S0: the
+// peripheral clocks ADC1 conversions straight into DMA buffers with no CPU
+// involvement per sample. A background task wakes once per filled DMA
+// buffer, runs the fixed-point decimating filter from AdcFilter.h over it
+// and converts each output through the calibration table. Readings are
+// queued (read()) and kept as the latest value (last()).
+
+#pragma once
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <freertos/queue.h>
+#include "AdcFilter.h"
+
+#define LDR_SAMPLE_RATE     20000   // ADC conversions per second
+#define LDR_DMA_BUF_LEN     256     // samples per DMA buffer
+#define LDR_DMA_BUF_COUNT   4
+#define LDR_QUEUE_LEN       4
+#define LDR_TASK_STACK      3072
+#define LDR_TASK_PRIORITY   2
+
+struct LdrReading {
+    uint16_t filtered;     // counts << ADC_FILTER_FRAC_BITS
+    uint16_t millivolts;
+    uint32_t deciLux;      // lux * 10
+    uint32_t timestamp;    // millis() at the end of the window
+
+    uint16_t counts() const { return filtered >> ADC_FILTER_FRAC_BITS; }
+    float volts() const { return millivolts / 1000.0f; }
+    float lux() const { return deciLux / 10.0f; }
+};
+
+class LdrAdc {
+public:
+    // GPIO 34 is ADC1 channel 6
+    LdrAdc(adc1_channel_t channel = ADC1_CHANNEL_6, uint32_t sampleRate = LDR_SAMPLE_RATE,
+           const LdrModel& model = LDR_MODEL_DEFAULT);
+
+    // Starts sampling; one filtered reading per 1/outputHz
+    bool begin(uint16_t outputHz = 10);
+    void setOutputRate(uint16_t outputHz);
+
+    bool read(LdrReading& out);   // next queued reading, never blocks
+    LdrReading last() const;
+
+    uint32_t samples() const { return numSamples; }
+    uint32_t readings() const { return numReadings; }
+
+private:
+    static void taskEntry(void* arg);
+    void run();
+    void emit(uint16_t filtered);
+
+    adc1_channel_t channel;
+    uint32_t sampleRate;
+    LdrModel model;
+    AdcDecimator filter;
+    AdcCalibration calibration;
+    volatile uint32_t pendingFactor;   // applied by the task between buffers
+    QueueHandle_t queue;
+    TaskHandle_t task;
+    mutable portMUX_TYPE lock;
+    LdrReading latest;
+    volatile uint32_t numSamples;
+    volatile uint32_t numReadings;
+};
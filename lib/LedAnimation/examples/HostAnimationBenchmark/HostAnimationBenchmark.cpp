@@ -0,0 +1,117 @@
+// Host cost comparison for the LED animation engine (not an Arduino sketch)
+//
+//   g++ -O2 -std=c++11 -I../../src HostAnimationBenchmark.cpp -o bench && ./bench
+//
+// Computes the 3-channel PWM fade of Assignment1 for 8 ms frames:
+//   float  - the sketch's old MODE_FADE code: three double sin() calls,
+//            float scaling and casts per frame
+//   table  - Animator with the same pattern (gamma off, to compare levels)
+//   gamma  - Animator as the sketch now runs it
+// and reports ns per frame plus the largest level difference float vs table.
+// On the ESP32 (no FPU for double) the gap is far wider than on a PC.
+
+#include <LedAnimation.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static const uint32_t FRAMES = 20000000;
+static const uint32_t FRAME_MS = 8;
+static const int REPEAT = 5;
+
+static const LedPattern FADE = { "fade", false, {
+    { WAVE_SINE, 2000, 0,   0, 0, 255 },
+    { WAVE_SINE, 2000, 85,  0, 0, 255 },
+    { WAVE_SINE, 2000, 171, 0, 0, 255 } } };
+
+static const LedPattern FADE_GAMMA = { "fade", true, {
+    { WAVE_SINE, 2000, 0,   0, 0, 255 },
+    { WAVE_SINE, 2000, 85,  0, 0, 255 },
+    { WAVE_SINE, 2000, 171, 0, 0, 255 } } };
+
+// The previous MODE_FADE body, verbatim apart from ledcWrite
+static void floatFrame(unsigned long now, unsigned long fadeTimer, uint8_t out[3]) {
+    unsigned long elapsed = (now - fadeTimer) % 2000;
+    float t = elapsed / 2000.0f;
+    float r = (sin(2 * M_PI * t) + 1.0f) / 2.0f;
+    float g = (sin(2 * M_PI * (t + 1.0 / 3.0)) + 1.0f) / 2.0f;
+    float y = (sin(2 * M_PI * (t + 2.0 / 3.0)) + 1.0f) / 2.0f;
+    out[0] = (int)(r * 255);
+    out[1] = (int)(g * 255);
+    out[2] = (int)(y * 255);
+}
+
+template <typename F>
+static double bestSeconds(F fn) {
+    double best = 1e9;
+    for (int r = 0; r < REPEAT; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+int main() {
+    volatile uint32_t sink = 0;
+
+    double tFloat = bestSeconds([&] {
+        uint32_t acc = 0;
+        uint8_t out[3];
+        for (uint32_t i = 0; i < FRAMES; i++) {
+            floatFrame(i * FRAME_MS, 0, out);
+            acc += out[0] + out[1] + out[2];
+        }
+        sink = acc;
+    });
+
+    double tTable = bestSeconds([&] {
+        uint32_t acc = 0;
+        uint8_t out[3];
+        Animator a;
+        a.start(FADE, 0);
+        for (uint32_t i = 0; i < FRAMES; i++) {
+            a.update(i * FRAME_MS, out);
+            acc += out[0] + out[1] + out[2];
+        }
+        sink = acc;
+    });
+
+    double tGamma = bestSeconds([&] {
+        uint32_t acc = 0;
+        uint8_t out[3];
+        Animator a;
+        a.start(FADE_GAMMA, 0);
+        for (uint32_t i = 0; i < FRAMES; i++) {
+            a.update(i * FRAME_MS, out);
+            acc += out[0] + out[1] + out[2];
+        }
+        sink = acc;
+    });
+
+    // Levels over one 2 s cycle; the table has 256 steps per turn, so
+    // expect a few counts of quantisation on the steep parts of the curve
+    int worst = 0;
+    Animator a;
+    a.start(FADE, 0);
+    for (uint32_t now = 0; now < 2000; now += FRAME_MS) {
+        uint8_t f[3], t[3];
+        floatFrame(now, 0, f);
+        a.update(now, t);
+        for (int c = 0; c < 3; c++) {
+            int d = abs((int)f[c] - (int)t[c]);
+            if (d > worst) worst = d;
+        }
+    }
+
+    printf("%u frames of %u ms, best of %d\n", (unsigned)FRAMES, (unsigned)FRAME_MS, REPEAT);
+    printf("  float   %6.2f ns/frame\n", tFloat * 1e9 / FRAMES);
+    printf("  table   %6.2f ns/frame  (%.1fx)\n", tTable * 1e9 / FRAMES, tFloat / tTable);
+    printf("  gamma   %6.2f ns/frame  (%.1fx)\n", tGamma * 1e9 / FRAMES, tFloat / tGamma);
+    printf("  max level difference float vs table: %d / 255\n", worst);
+    (void)sink;
+    return 0;
+}
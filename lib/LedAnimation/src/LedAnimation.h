@@ -0,0 +1,100 @@
+// Table-driven LED animation engine
+// A pattern is plain data: per channel a waveform, a period, a phase offset
+// and a brightness range. Animator turns it into 8-bit PWM levels with a
+// 32-bit phase accumulator per channel; a frame is, per channel, one
+// multiply-add, a table lookup (WaveTables.h), a scale and optionally a
+// gamma lookup - no floating point, no trigonometry.
+//
+// Plain C++ with no Arduino dependencies: update() only computes levels
+// (and which ones changed), the sketch writes them to LEDC. The host
+// benchmark in examples/HostAnimationBenchmark runs the same code.
+
+#pragma once
+
+#include <stdint.h>
+#include <WaveTables.h>
+
+#define LED_ANIM_CHANNELS 3
+
+enum WaveShape : uint8_t {
+    WAVE_OFF = 0,    // lo
+    WAVE_ON,         // hi
+    WAVE_SINE,
+    WAVE_TRIANGLE,
+    WAVE_SQUARE      // hi for the first `duty`/256 of the period, else lo
+};
+
+struct ChannelTrack {
+    WaveShape shape;
+    uint16_t periodMs;
+    uint8_t offset;   // phase offset in 1/256 turns
+    uint8_t duty;     // WAVE_SQUARE only
+    uint8_t lo;
+    uint8_t hi;
+};
+
+struct LedPattern {
+    const char* name;
+    bool gamma;       // map through WAVE_GAMMA8 (smooth fades look linear)
+    ChannelTrack ch[LED_ANIM_CHANNELS];
+};
+
+class Animator {
+public:
+    Animator() : pattern(nullptr), last(0) {}
+
+    void start(const LedPattern& p, uint32_t nowMs) {
+        pattern = &p;
+        last = nowMs;
+        for (uint8_t i = 0; i < LED_ANIM_CHANNELS; i++) {
+            const ChannelTrack& t = p.ch[i];
+            phase[i] = (uint32_t)t.offset << 24;
+            step[i] = t.periodMs ? (uint32_t)((1ULL << 32) / t.periodMs) : 0;   // per ms
+            level[i] = 0xFFFF;   // first update() reports every channel
+        }
+    }
+
+    // Advances every channel to nowMs and writes the levels to out.
+    // Returns a bit mask of the channels whose level changed.
+    uint8_t update(uint32_t nowMs, uint8_t out[LED_ANIM_CHANNELS]) {
+        if (!pattern) return 0;
+        // A `now` sampled before start() would otherwise wrap to ~49 days
+        uint32_t dt = (int32_t)(nowMs - last) > 0 ? nowMs - last : 0;
+        last += dt;
+
+        uint8_t changed = 0;
+        for (uint8_t i = 0; i < LED_ANIM_CHANNELS; i++) {
+            phase[i] += dt * step[i];
+            uint8_t v = levelOf(pattern->ch[i], phase[i] >> 24);
+            if (pattern->gamma) v = WAVE_GAMMA8[v];
+            out[i] = v;
+            if (v != level[i]) {
+                level[i] = v;
+                changed |= 1 << i;
+            }
+        }
+        return changed;
+    }
+
+    const LedPattern* current() const { return pattern; }
+
+private:
+    static uint8_t levelOf(const ChannelTrack& t, uint8_t idx) {
+        uint8_t w;
+        switch (t.shape) {
+            case WAVE_ON:       return t.hi;
+            case WAVE_SINE:     w = WAVE_SINE8[idx]; break;
+            case WAVE_TRIANGLE: w = idx < 128 ? idx * 2 : (255 - idx) * 2; break;
+            case WAVE_SQUARE:   return idx < t.duty ? t.hi : t.lo;
+            default:            return t.lo;
+        }
+        // lo + (hi - lo) * w / 255, rounded
+        return t.lo + (((t.hi - t.lo) * w * 257 + 32768) >> 16);
+    }
+
+    const LedPattern* pattern;
+    uint32_t last;
+    uint32_t phase[LED_ANIM_CHANNELS];
+    uint32_t step[LED_ANIM_CHANNELS];
+    uint16_t level[LED_ANIM_CHANNELS];
+};
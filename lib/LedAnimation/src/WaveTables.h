@@ -0,0 +1,79 @@
+// Compile-time waveform and gamma tables for LED animation
+// Both tables are computed by the compiler (C++11 constexpr) and land in
+// flash as 256 plain bytes each; nothing runs at startup and no libm code
+// is linked in.
+//
+//   WAVE_SINE8[i]   = round((sin(2*pi*i/256) + 1) / 2 * 255)
+//   WAVE_GAMMA8[i]  = round(255 * (i/255)^2.25)   perceived -> PWM duty
+//
+// The gamma exponent is 2.25 rather than the usual 2.2 so it can be built
+// from x^2 * sqrt(sqrt(x)) with constexpr square roots.
+
+#pragma once
+
+#include <stdint.h>
+
+struct WaveTable {
+    uint8_t v[256];
+
+    constexpr uint8_t operator[](uint8_t i) const { return v[i]; }
+};
+
+// ---------- constexpr maths (evaluated by the compiler only) ----------
+
+#define WAVE_PI 3.14159265358979323846
+
+// Taylor series up to x^15; exact to double precision for |x| <= pi/2
+constexpr double waveSinSeries(double x, double term, double sum, int k) {
+    return k > 15 ? sum : waveSinSeries(x, -term * x * x / ((k + 1) * (k + 2)), sum + term, k + 2);
+}
+
+// sin(2*pi*t) for t in [0, 1), folded into [-pi/2, pi/2]
+constexpr double waveSinTurns(double t) {
+    return t < 0.25 ? waveSinSeries(2 * WAVE_PI * t, 2 * WAVE_PI * t, 0.0, 1)
+         : t < 0.75 ? waveSinSeries(WAVE_PI - 2 * WAVE_PI * t, WAVE_PI - 2 * WAVE_PI * t, 0.0, 1)
+         : waveSinSeries(2 * WAVE_PI * t - 2 * WAVE_PI, 2 * WAVE_PI * t - 2 * WAVE_PI, 0.0, 1);
+}
+
+// Newton iteration from 1; 24 steps converge for every x in [0, 1]
+constexpr double waveSqrt(double x, double g = 1.0, int n = 24) {
+    return n == 0 ? g : waveSqrt(x, 0.5 * (g + x / g), n - 1);
+}
+
+constexpr uint8_t waveSine8(uint16_t i) {
+    return (uint8_t)((waveSinTurns(i / 256.0) + 1.0) * 127.5 + 0.5);
+}
+
+constexpr uint8_t waveGamma8(uint16_t i) {
+    return (uint8_t)(255.0 * (i / 255.0) * (i / 255.0) * waveSqrt(waveSqrt(i / 255.0)) + 0.5);
+}
+
+// ---------- table generation: 0..255 as a parameter pack ----------
+
+template <uint16_t... I>
+struct WaveIndices {};
+
+template <uint16_t N, uint16_t... I>
+struct MakeWaveIndices : MakeWaveIndices<N - 1, N - 1, I...> {};
+
+template <uint16_t... I>
+struct MakeWaveIndices<0, I...> {
+    typedef WaveIndices<I...> type;
+};
+
+template <uint16_t... I>
+constexpr WaveTable waveMakeSine(WaveIndices<I...>) {
+    return WaveTable{ { waveSine8(I)... } };
+}
+
+template <uint16_t... I>
+constexpr WaveTable waveMakeGamma(WaveIndices<I...>) {
+    return WaveTable{ { waveGamma8(I)... } };
+}
+
+constexpr WaveTable WAVE_SINE8 = waveMakeSine(MakeWaveIndices<256>::type());
+constexpr WaveTable WAVE_GAMMA8 = waveMakeGamma(MakeWaveIndices<256>::type());
+
+static_assert(WAVE_SINE8[0] == 128 && WAVE_SINE8[64] == 255 && WAVE_SINE8[192] == 0,
+              "sine table off");
+static_assert(WAVE_GAMMA8[0] == 0 && WAVE_GAMMA8[255] == 255, "gamma table off");
@@ -0,0 +1,209 @@
+#include "LedcFader.h"
+#include <esp_timer.h>
+
+// Arduino channel n is LEDC channel n % 8 of speed mode n / 8
+#define FADE_MODE(ch)  ((ledc_mode_t)((ch) / 8))
+#define FADE_CHAN(ch)  ((ledc_channel_t)((ch) % 8))
+
+#define FADE_CMD_BIT   (1UL << FADE_MAX_CHANNELS)   // notification: command queued
+
+LedcFader::LedcFader()
+    : commands(nullptr), events(nullptr), task(nullptr), lock(portMUX_INITIALIZER_UNLOCKED) {
+    memset(channels, 0, sizeof(channels));
+    counters = { 0, 0, 0, 0 };
+}
+
+bool LedcFader::begin() {
+    esp_err_t err = ledc_fade_func_install(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;   // installed already is fine
+
+    commands = xQueueCreate(FADE_QUEUE_LEN, sizeof(Command));
+    events = xQueueCreate(FADE_EVENT_LEN, sizeof(FadeEvent));
+    if (!commands || !events) return false;
+    return xTaskCreate(taskEntry, "fade", FADE_TASK_STACK, this, FADE_TASK_PRIORITY, &task) == pdPASS;
+}
+
+bool LedcFader::attach(uint8_t channel, uint8_t resolutionBits) {
+    if (!task || channel >= FADE_MAX_CHANNELS) return false;
+    ledc_cbs_t cbs = { onFadeEnd };
+    if (ledc_cb_register(FADE_MODE(channel), FADE_CHAN(channel), &cbs, this) != ESP_OK) return false;
+    channels[channel].maxDuty = (1U << resolutionBits) - 1;
+    channels[channel].attached = true;
+    return true;
+}
+
+bool LedcFader::play(uint8_t channel, const FadeRamp* ramps, uint8_t count, bool repeat) {
+    if (!ramps || !count || count > FADE_MAX_RAMPS) return false;
+    Command cmd;
+    cmd.channel = channel;
+    memcpy(cmd.chain.ramps, ramps, count * sizeof(FadeRamp));
+    cmd.chain.count = count;
+    cmd.chain.repeat = repeat;
+    cmd.chain.parts = 0;
+    cmd.chain.fullScaleMs = 0;
+    return submit(cmd);
+}
+
+bool LedcFader::fadeTo(uint8_t channel, uint16_t duty, uint16_t fullScaleMs, uint8_t parts) {
+    Command cmd;
+    cmd.channel = channel;
+    cmd.chain.ramps[0] = { duty, 0 };
+    cmd.chain.count = 0;
+    cmd.chain.repeat = false;
+    cmd.chain.parts = constrain(parts, 1, FADE_MAX_RAMPS);
+    cmd.chain.fullScaleMs = fullScaleMs;
+    return submit(cmd);
+}
+
+bool LedcFader::submit(const Command& cmd) {
+    if (cmd.channel >= FADE_MAX_CHANNELS || !channels[cmd.channel].attached) return false;
+    if (xQueueSend(commands, &cmd, 0) != pdTRUE) return false;
+    xTaskNotify(task, FADE_CMD_BIT, eSetBits);
+    return true;
+}
+
+bool LedcFader::read(FadeEvent& out) {
+    return events && xQueueReceive(events, &out, 0) == pdTRUE;
+}
+
+FadeStats LedcFader::stats() const {
+    portENTER_CRITICAL(&lock);
+    FadeStats s = counters;
+    portEXIT_CRITICAL(&lock);
+    return s;
+}
+
+// LEDC interrupt: the fade on one channel reached its target
+bool IRAM_ATTR LedcFader::onFadeEnd(const ledc_cb_param_t* param, void* arg) {
+    if (param->event != LEDC_FADE_END_EVT) return false;
+    LedcFader* self = static_cast<LedcFader*>(arg);
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(self->task, 1UL << (param->speed_mode * 8 + param->channel), eSetBits, &woken);
+    return woken == pdTRUE;
+}
+
+void LedcFader::taskEntry(void* arg) {
+    static_cast<LedcFader*>(arg)->run();
+}
+
+void LedcFader::run() {
+    for (;;) {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+        int64_t t0 = esp_timer_get_time();
+
+        for (uint8_t ch = 0; ch < FADE_MAX_CHANNELS; ch++) {
+            Channel& c = channels[ch];
+            if (!(bits & (1UL << ch)) || !c.busy) continue;
+            c.busy = false;
+            if (c.pending) {
+                // Superseded: no events for the rest of the old chain
+                c.pending = false;
+                c.chain = c.next;
+                startChain(ch);
+            } else {
+                advance(ch);
+            }
+        }
+
+        Command cmd;
+        while (xQueueReceive(commands, &cmd, 0) == pdTRUE) {
+            Channel& c = channels[cmd.channel];
+            if (c.busy) {
+                c.next = cmd.chain;
+                c.pending = true;
+            } else {
+                c.chain = cmd.chain;
+                startChain(cmd.channel);
+            }
+        }
+
+        uint32_t spent = (uint32_t)(esp_timer_get_time() - t0);
+        portENTER_CRITICAL(&lock);
+        counters.wakeups++;
+        counters.busyUs += spent;
+        portEXIT_CRITICAL(&lock);
+    }
+}
+
+void LedcFader::startChain(uint8_t ch) {
+    Channel& c = channels[ch];
+    Chain& k = c.chain;
+
+    if (k.parts) {
+        // fadeTo(): split the remaining distance now that the start is known
+        int32_t from = ledc_get_duty(FADE_MODE(ch), FADE_CHAN(ch));
+        int32_t to = min<int32_t>(k.ramps[0].duty, c.maxDuty);
+        uint32_t ms = (uint32_t)abs(to - from) * k.fullScaleMs / c.maxDuty;
+        k.count = from == to ? 0 : k.parts;
+        for (uint8_t i = 0; i < k.count; i++) {
+            k.ramps[i].duty = from + (to - from) * (i + 1) / k.count;
+            k.ramps[i].ms = ms / k.count;
+        }
+        k.parts = 0;
+    }
+
+    c.index = 0;
+    if (!k.count) {
+        FadeEvent ev = { ch, 0, 0, (uint16_t)ledc_get_duty(FADE_MODE(ch), FADE_CHAN(ch)), true };
+        emit(ev);
+        return;
+    }
+    if (!startRamp(ch)) advance(ch);
+}
+
+// False if the ramp needed no fade (no change or no time); it is then
+// already complete
+bool LedcFader::startRamp(uint8_t ch) {
+    Channel& c = channels[ch];
+    const FadeRamp& r = c.chain.ramps[c.index];
+    ledc_mode_t mode = FADE_MODE(ch);
+    ledc_channel_t chan = FADE_CHAN(ch);
+    uint32_t duty = min<uint32_t>(r.duty, c.maxDuty);
+
+    if (r.ms == 0 || ledc_get_duty(mode, chan) == duty) {
+        ledc_set_duty(mode, chan, duty);
+        ledc_update_duty(mode, chan);
+        return false;
+    }
+
+    ledc_set_fade_with_time(mode, chan, duty, r.ms);
+    ledc_fade_start(mode, chan, LEDC_FADE_NO_WAIT);
+    c.busy = true;
+
+    portENTER_CRITICAL(&lock);
+    counters.ramps++;
+    counters.rampMs += r.ms;
+    portEXIT_CRITICAL(&lock);
+    return true;
+}
+
+// The current ramp ended: report it and start the next one. Ramps that
+// complete on the spot are stepped over here; a repeating chain made only
+// of those ends after a pass instead of spinning.
+void LedcFader::advance(uint8_t ch) {
+    Channel& c = channels[ch];
+    Chain& k = c.chain;
+
+    for (uint8_t instant = 0;; instant++) {
+        FadeEvent ev = { ch, c.index, k.count, (uint16_t)ledc_get_duty(FADE_MODE(ch), FADE_CHAN(ch)), false };
+        if (++c.index >= k.count) {
+            if (!k.repeat || instant >= k.count) {
+                ev.done = true;
+                emit(ev);
+                return;
+            }
+            c.index = 0;
+        }
+        emit(ev);
+        if (startRamp(ch)) return;
+    }
+}
+
+void LedcFader::emit(const FadeEvent& ev) {
+    if (xQueueSend(events, &ev, 0) != pdTRUE) {
+        FadeEvent dropped;
+        xQueueReceive(events, &dropped, 0);   // keep the newest
+        xQueueSend(events, &ev, 0);
+    }
+}
@@ -0,0 +1,110 @@
+// LED fades on the LEDC hardware fade engine
+// A ramp (target duty, time) is handed to the LEDC peripheral, which steps
+// the duty by itself and raises a fade-end interrupt when it gets there.
+// The interrupt only sets a notification bit for a small task, which starts
+// the next ramp of the chain - so the CPU runs once per ramp, not once per
+// brightness step like a vTaskDelay() fade loop.
+//
+// Chains are copied, up to FADE_MAX_RAMPS ramps, optionally repeating.
+// A chain given to a channel that is still fading starts when the running
+// ramp ends: the IDF 4.x driver cannot stop a fade half way.
+// Ramp ends are queued as events for loop() (oldest dropped), read() is
+// optional and never blocks.
+
+#pragma once
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include <freertos/queue.h>
+
+#define FADE_MAX_CHANNELS   16     // Arduino LEDC channels 0-15
+#define FADE_MAX_RAMPS      4
+#define FADE_QUEUE_LEN      8      // chains waiting for the task
+#define FADE_EVENT_LEN      8      // events kept for read()
+#define FADE_TASK_STACK     2048
+#define FADE_TASK_PRIORITY  3
+
+struct FadeRamp {
+    uint16_t duty;   // target, in the channel's resolution
+    uint16_t ms;     // time to get there from the previous duty
+};
+
+struct FadeEvent {
+    uint8_t channel;
+    uint8_t ramp;     // index of the ramp that ended
+    uint8_t count;    // ramps in the chain
+    uint16_t duty;    // duty reached
+    bool done;        // last ramp of a chain that does not repeat
+};
+
+struct FadeStats {
+    uint32_t ramps;     // hardware ramps started
+    uint32_t rampMs;    // their total length
+    uint32_t wakeups;   // times the fade task ran
+    uint32_t busyUs;    // CPU time it spent
+};
+
+class LedcFader {
+public:
+    LedcFader();
+
+    // Installs the LEDC fade interrupt service and starts the task
+    bool begin();
+
+    // Registers a channel already set up with ledcSetup()/ledcAttachPin()
+    bool attach(uint8_t channel, uint8_t resolutionBits);
+
+    // Plays count ramps; false if the channel is not attached or the
+    // command queue is full
+    bool play(uint8_t channel, const FadeRamp* ramps, uint8_t count, bool repeat = false);
+
+    // Ramps from wherever the channel is when the fade starts to duty, at
+    // fullScaleMs per 0..max swing (shorter swings are quicker), split into
+    // parts equal ramps so that each part reports an event
+    bool fadeTo(uint8_t channel, uint16_t duty, uint16_t fullScaleMs, uint8_t parts = 1);
+
+    // Next ramp-end event, false if none is waiting. Never blocks.
+    bool read(FadeEvent& out);
+
+    FadeStats stats() const;
+
+private:
+    struct Chain {
+        FadeRamp ramps[FADE_MAX_RAMPS];
+        uint8_t count;
+        bool repeat;
+        uint8_t parts;          // fadeTo(): ramps[0].duty is the target, split at start
+        uint16_t fullScaleMs;
+    };
+
+    struct Command {
+        uint8_t channel;
+        Chain chain;
+    };
+
+    struct Channel {
+        bool attached;
+        uint16_t maxDuty;
+        bool busy;       // a hardware fade is running
+        bool pending;    // `next` replaces the chain when it ends
+        uint8_t index;
+        Chain chain;
+        Chain next;
+    };
+
+    static bool IRAM_ATTR onFadeEnd(const ledc_cb_param_t* param, void* arg);
+    static void taskEntry(void* arg);
+    void run();
+    bool submit(const Command& cmd);
+    void startChain(uint8_t ch);
+    bool startRamp(uint8_t ch);
+    void advance(uint8_t ch);
+    void emit(const FadeEvent& ev);
+
+    Channel channels[FADE_MAX_CHANNELS];
+    QueueHandle_t commands;
+    QueueHandle_t events;
+    TaskHandle_t task;
+    mutable portMUX_TYPE lock;
+    FadeStats counters;
+};
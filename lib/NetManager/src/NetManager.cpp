@@ -0,0 +1,135 @@
+#include "NetManager.h"
+
+uint32_t NetBackoff::next() {
+    uint32_t base = currentMs;
+    currentMs = min(currentMs * 2, maxMs);
+    // +/-25% jitter keeps a fleet of nodes from retrying in lockstep
+    int32_t jitter = (int32_t)(esp_random() % (base / 2 + 1)) - (int32_t)(base / 4);
+    return base + jitter;
+}
+
+NetManager::NetManager()
+    : ssid(nullptr), pass(nullptr), wifiState(NET_DOWN), wifiDeadline(0), numLinks(0) {
+    wifiBackoff = { NET_BACKOFF_MIN_MS, NET_BACKOFF_MAX_MS, NET_BACKOFF_MIN_MS };
+}
+
+void NetManager::begin(const char* ssid, const char* pass) {
+    this->ssid = ssid;
+    this->pass = pass;
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false);   // reconnects are paced by our backoff
+    WiFi.begin(ssid, pass);
+    wifiState = NET_CONNECTING;
+    wifiDeadline = millis() + NET_WIFI_TIMEOUT_MS;
+}
+
+int8_t NetManager::addLink(const char* name, bool (*attempt)(), bool (*connected)(), void (*service)(),
+                           uint32_t backoffMinMs, uint32_t backoffMaxMs) {
+    if (numLinks >= NET_MAX_LINKS) return -1;
+    NetLink& l = links[numLinks];
+    l.name = name;
+    l.attempt = attempt;
+    l.connected = connected;
+    l.service = service;
+    l.state = NET_DOWN;
+    l.backoff = { backoffMinMs, backoffMaxMs, backoffMinMs };
+    l.retryAt = 0;
+    l.attempts = 0;
+    l.failures = 0;
+    return numLinks++;
+}
+
+void NetManager::loopWifi(uint32_t now) {
+    bool associated = WiFi.status() == WL_CONNECTED;
+
+    switch (wifiState) {
+        case NET_DOWN:
+            break;
+
+        case NET_CONNECTING:
+            if (associated) {
+                wifiState = NET_UP;
+                wifiBackoff.reset();
+                Serial.print("WiFi connected, IP: ");
+                Serial.println(WiFi.localIP());
+            } else if ((int32_t)(now - wifiDeadline) >= 0) {
+                WiFi.disconnect();
+                wifiState = NET_BACKOFF;
+                wifiDeadline = now + wifiBackoff.next();
+            }
+            break;
+
+        case NET_UP:
+            if (!associated) {
+                Serial.println("WiFi lost");
+                WiFi.disconnect();
+                wifiState = NET_BACKOFF;
+                wifiDeadline = now + wifiBackoff.next();
+            }
+            break;
+
+        case NET_BACKOFF:
+            if ((int32_t)(now - wifiDeadline) >= 0) {
+                WiFi.begin(ssid, pass);
+                wifiState = NET_CONNECTING;
+                wifiDeadline = now + NET_WIFI_TIMEOUT_MS;
+            }
+            break;
+    }
+}
+
+void NetManager::loopLink(NetLink& l, uint32_t now) {
+    if (wifiState != NET_UP) {
+        l.state = NET_DOWN;
+        return;
+    }
+
+    switch (l.state) {
+        case NET_DOWN:
+            // WiFi just came up: try right away
+            l.backoff.reset();
+            l.retryAt = now;
+            l.state = NET_BACKOFF;
+            // fall through
+        case NET_BACKOFF:
+        case NET_CONNECTING:
+            if ((int32_t)(now - l.retryAt) < 0) break;
+            l.state = NET_CONNECTING;
+            l.attempts++;
+            if (l.attempt()) {
+                l.state = NET_UP;
+                l.backoff.reset();
+                Serial.printf("%s connected\n", l.name);
+            } else {
+                l.failures++;
+                l.state = NET_BACKOFF;
+                l.retryAt = now + l.backoff.next();
+            }
+            break;
+
+        case NET_UP:
+            if (!l.connected()) {
+                Serial.printf("%s lost\n", l.name);
+                l.state = NET_BACKOFF;
+                l.retryAt = now + l.backoff.next();
+            } else if (l.service) {
+                l.service();
+            }
+            break;
+    }
+}
+
+void NetManager::loop() {
+    uint32_t now = millis();
+    loopWifi(now);
+    for (uint8_t i = 0; i < numLinks; i++) loopLink(links[i], now);
+}
+
+const char* NetManager::stateName(NetState s) {
+    switch (s) {
+        case NET_UP:         return "OK";
+        case NET_CONNECTING: return "..";
+        case NET_BACKOFF:    return "WAIT";
+        default:             return "DQ";
+    }
+}
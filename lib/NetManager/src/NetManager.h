@@ -0,0 +1,90 @@
+// Non-blocking connectivity manager shared by the networked sketches
+// WiFi and any number of dependent links (MQTT, Blynk, ...) each run their
+// own small state machine from loop(). Failed attempts back off
+// exponentially with +/-25% jitter, so a dead broker or access point costs
+// one short connection attempt per backoff period instead of a spin loop.
+//
+// loop() itself does not wait, but it runs attempt() inline: a blocking
+// connect there (client.connect(), Blynk.run()) holds loop() for up to that
+// client's connect timeout once per backoff period. Bound it (e.g.
+// WiFiClient::setTimeout()) and keep time-critical or user-visible work,
+// such as a display, out of the task that calls loop().
+//
+// Links are described by three plain callbacks:
+//   attempt()   start/perform one connection attempt, true if now connected
+//   connected() true while the link is up
+//   service()   per-loop work while up (client.loop(), Blynk.run(), ...)
+
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define NET_MAX_LINKS         4
+#define NET_WIFI_TIMEOUT_MS   15000UL   // one WiFi association attempt
+#define NET_BACKOFF_MIN_MS    1000UL
+#define NET_BACKOFF_MAX_MS    60000UL
+
+enum NetState : uint8_t {
+    NET_DOWN = 0,      // waiting for WiFi (links) / not started (WiFi)
+    NET_CONNECTING,
+    NET_UP,
+    NET_BACKOFF
+};
+
+struct NetBackoff {
+    uint32_t minMs;
+    uint32_t maxMs;
+    uint32_t currentMs;
+
+    void reset() { currentMs = minMs; }
+    // Returns the jittered delay to wait now and doubles the next one
+    uint32_t next();
+};
+
+struct NetLink {
+    const char* name;
+    bool (*attempt)();
+    bool (*connected)();
+    void (*service)();
+    NetState state;
+    NetBackoff backoff;
+    uint32_t retryAt;
+    uint32_t attempts;
+    uint32_t failures;
+};
+
+class NetManager {
+public:
+    NetManager();
+
+    // Starts WiFi association without waiting for it
+    void begin(const char* ssid, const char* pass);
+
+    // Registers a link that needs WiFi; returns its index or -1
+    int8_t addLink(const char* name, bool (*attempt)(), bool (*connected)(), void (*service)(),
+                   uint32_t backoffMinMs = NET_BACKOFF_MIN_MS, uint32_t backoffMaxMs = NET_BACKOFF_MAX_MS);
+
+    // Drives every state machine. Blocks only inside an attempt() callback,
+    // for as long as that callback's connect takes.
+    void loop();
+
+    bool wifiUp() const { return wifiState == NET_UP; }
+    NetState wifiStatus() const { return wifiState; }
+    bool linkUp(uint8_t i) const { return i < numLinks && links[i].state == NET_UP; }
+    const NetLink& link(uint8_t i) const { return links[i]; }
+
+    static const char* stateName(NetState s);
+
+private:
+    void loopWifi(uint32_t now);
+    void loopLink(NetLink& l, uint32_t now);
+
+    const char* ssid;
+    const char* pass;
+    NetState wifiState;
+    NetBackoff wifiBackoff;
+    uint32_t wifiDeadline;
+    NetLink links[NET_MAX_LINKS];
+    uint8_t numLinks;
+};
@@ -0,0 +1,130 @@
+// Bytes on the bus and frame time per update: stock full-frame display()
+// against PagedSSD1306::display(), for the screens used by the sketches.
+// Both paths are counted at the Wire object, so the stock figure includes
+// Adafruit's control byte per WIRE_MAX chunk and its address window.
+// Wiring: SSD1306 on SDA 21 / SCL 22, address 0x3C. Results go to Serial.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <PagedSSD1306.h>
+
+#define UPDATES_PER_SCREEN 50
+
+// Counts every byte written to the bus (I2C address bytes excluded)
+class CountingWire : public TwoWire {
+public:
+    explicit CountingWire(uint8_t bus) : TwoWire(bus), bytes(0) {}
+    using TwoWire::write;
+    size_t write(uint8_t data) override { bytes++; return TwoWire::write(data); }
+    size_t write(const uint8_t* data, size_t len) override { bytes += len; return TwoWire::write(data, len); }
+    uint32_t bytes;
+};
+
+CountingWire bus(0);   // I2C port 0, in place of Wire
+PagedSSD1306 display(128, 64, &bus, -1);
+
+// Smart-Aquarium status screen (clock ticks every update)
+void drawAquarium(int i) {
+  display.clearDisplay();
+  display.setCursor(0, 0);
+  display.printf("Time: %02d:%02d\n", 10 + i / 60, i % 60);
+  display.printf("Pump: %s %s\n", "ON", "");
+  display.printf("Heat: %s %s\n", "OFF", "(M)");
+  display.printf("Light: %s %s\n", "ON", "");
+  display.printf("Blynk: %s\n", "OK");
+}
+
+// Week6 / Week9 / Week10 DHT (+LDR) screen (values drift)
+void drawDht(int i) {
+  display.clearDisplay();
+  display.setCursor(0, 0);
+  display.println("Hello IoT");
+  display.setCursor(0, 16);
+  display.print("Temp: ");
+  display.print(24.0f + (i % 7) * 0.1f, 1);
+  display.println(" C");
+  display.setCursor(0, 32);
+  display.print("Humidity: ");
+  display.print(55 + i % 3);
+  display.println(" %");
+  display.setCursor(0, 54);
+  display.print("LDR:");
+  display.print(1800 + (i * 37) % 200);
+}
+
+// Week13 subscriber screen (mostly static)
+void drawMqtt(int i) {
+  display.clearDisplay();
+  display.setCursor(0, 0);
+  display.println("MQTT Temp Monitor");
+  display.println("home/node-red/temp");
+  display.println("----------------");
+  display.setCursor(0, 25);
+  display.print("Temp: ");
+  display.print(21.5f + (i % 4) * 0.5f, 1);
+  display.println("C");
+}
+
+// Assignment1 mode screen (large text, changes on every 10th update)
+void drawMode(int i) {
+  static const char* modes[] = { "All OFF", "Alternate", "All ON", "PWM Fade" };
+  display.clearDisplay();
+  display.setTextSize(1);
+  display.setCursor(0, 0);
+  display.println("Mode:");
+  display.setTextSize(2);
+  display.setCursor(0, 20);
+  display.println(modes[(i / 10) % 4]);
+  display.setTextSize(1);
+}
+
+void bench(const char* name, void (*draw)(int)) {
+  // Stock path: every update pushes the whole frame
+  uint32_t fullUs = 0;
+  uint32_t fullBytes = bus.bytes;
+  for (int i = 0; i < UPDATES_PER_SCREEN; i++) {
+    draw(i);
+    uint32_t t0 = micros();
+    display.Adafruit_SSD1306::display();
+    fullUs += micros() - t0;
+  }
+  fullBytes = bus.bytes - fullBytes;
+
+  // Incremental path
+  display.invalidate();
+  draw(0);
+  display.display();
+  display.resetStats();
+  uint32_t pagedBytes = bus.bytes;
+  for (int i = 1; i <= UPDATES_PER_SCREEN; i++) {
+    draw(i);
+    display.display();
+  }
+  pagedBytes = bus.bytes - pagedBytes;
+
+  const PagedSSD1306Stats& s = display.stats();
+  Serial.printf("%-10s full: %4lu B %6lu us | paged: %4lu B %6lu us (max %lu us, %lu unchanged)\n",
+                name, (unsigned long)(fullBytes / UPDATES_PER_SCREEN), (unsigned long)(fullUs / UPDATES_PER_SCREEN),
+                (unsigned long)(pagedBytes / UPDATES_PER_SCREEN),
+                (unsigned long)(s.totalFrameUs / UPDATES_PER_SCREEN), (unsigned long)s.maxFrameUs,
+                (unsigned long)s.framesSkipped);
+}
+
+void setup() {
+  Serial.begin(115200);
+  bus.begin(21, 22);
+  if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+    Serial.println("SSD1306 allocation failed");
+    for (;;);
+  }
+  display.setTextSize(1);
+  display.setTextColor(SSD1306_WHITE);
+
+  Serial.println("screen     per update (average)");
+  bench("aquarium", drawAquarium);
+  bench("dht+ldr", drawDht);
+  bench("mqtt-sub", drawMqtt);
+  bench("assign1", drawMode);
+}
+
+void loop() {}
@@ -0,0 +1,95 @@
+#include "PagedSSD1306.h"
+
+PagedSSD1306::PagedSSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin,
+                           uint32_t clkDuring, uint32_t clkAfter)
+    : Adafruit_SSD1306(w, h, twi, rst_pin, clkDuring, clkAfter),
+      shadow(nullptr), shadowValid(false) {
+    resetStats();
+}
+
+PagedSSD1306::~PagedSSD1306() {
+    free(shadow);
+}
+
+bool PagedSSD1306::begin(uint8_t switchvcc, uint8_t i2caddr, bool reset, bool periphBegin) {
+    if (!Adafruit_SSD1306::begin(switchvcc, i2caddr, reset, periphBegin)) return false;
+    if (!shadow) shadow = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8));
+    shadowValid = false;
+    return shadow != nullptr;
+}
+
+// One page, columns col0..col1 inclusive
+void PagedSSD1306::sendRange(uint8_t page, uint8_t col0, uint8_t col1) {
+    const uint8_t window[] = { SSD1306_PAGEADDR, page, page, SSD1306_COLUMNADDR, col0, col1 };
+    ssd1306_commandList(window, sizeof(window));
+    counters.lastBytes += sizeof(window) + 1;   // + control byte
+
+    const uint8_t* src = getBuffer() + page * WIDTH + col0;
+    uint16_t remaining = col1 - col0 + 1;
+    while (remaining) {
+        uint8_t n = remaining > PAGED_SSD1306_CHUNK ? PAGED_SSD1306_CHUNK : remaining;
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x40);   // Co = 0, D/C = 1: data stream
+        wire->write(src, n);
+        wire->endTransmission();
+        src += n;
+        remaining -= n;
+        counters.lastBytes += n + 1;
+    }
+}
+
+void PagedSSD1306::display() {
+    uint32_t start = micros();
+    counters.frames++;
+    counters.lastBytes = 0;
+
+    // SPI panels or a failed allocation take the stock full-frame path
+    if (!wire || !shadow) {
+        Adafruit_SSD1306::display();
+        counters.lastBytes = WIDTH * ((HEIGHT + 7) / 8);
+    } else {
+        const uint8_t* buf = getBuffer();
+        const uint8_t pages = (HEIGHT + 7) / 8;
+        bool any = false;
+
+        wire->setClock(wireClk);
+        for (uint8_t page = 0; page < pages; page++) {
+            const uint8_t* row = buf + page * WIDTH;
+            uint8_t* old = shadow + page * WIDTH;
+
+            int16_t first = -1, last = -1;
+            if (!shadowValid) {
+                first = 0;
+                last = WIDTH - 1;
+            } else {
+                for (int16_t x = 0; x < WIDTH; x++) {
+                    if (row[x] != old[x]) { first = x; break; }
+                }
+                if (first < 0) continue;
+                for (int16_t x = WIDTH - 1; x >= first; x--) {
+                    if (row[x] != old[x]) { last = x; break; }
+                }
+            }
+
+            sendRange(page, first, last);
+            memcpy(old + first, row + first, last - first + 1);
+            any = true;
+        }
+        wire->setClock(restoreClk);
+
+        shadowValid = true;
+        if (!any) counters.framesSkipped++;
+    }
+
+    counters.bytesSent += counters.lastBytes;
+    counters.lastFrameUs = micros() - start;
+    counters.totalFrameUs += counters.lastFrameUs;
+    if (counters.lastFrameUs > counters.maxFrameUs) counters.maxFrameUs = counters.lastFrameUs;
+}
+
+void PagedSSD1306::printStats(Print& out) const {
+    out.printf("OLED frames=%lu skipped=%lu bytes=%lu last=%luB/%luus max=%luus\n",
+               (unsigned long)counters.frames, (unsigned long)counters.framesSkipped,
+               (unsigned long)counters.bytesSent, (unsigned long)counters.lastBytes,
+               (unsigned long)counters.lastFrameUs, (unsigned long)counters.maxFrameUs);
+}
@@ -0,0 +1,49 @@
+// Incremental SSD1306 driver shared by the sketches in this repository
+// Drop-in replacement for Adafruit_SSD1306 over I2C: display() compares the
+// framebuffer with the copy last pushed to the panel and only transmits the
+// changed column range of each 8-row page. A typical status screen where one
+// number changes costs tens of bytes instead of the full 1 KB frame.
+
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+
+#define PAGED_SSD1306_CHUNK 30   // data bytes per I2C transaction (+1 control byte)
+
+struct PagedSSD1306Stats {
+    uint32_t frames;        // display() calls
+    uint32_t framesSkipped; // calls where nothing had changed
+    uint32_t bytesSent;     // payload + addressing bytes on the bus
+    uint32_t lastBytes;
+    uint32_t lastFrameUs;
+    uint32_t totalFrameUs;
+    uint32_t maxFrameUs;
+};
+
+class PagedSSD1306 : public Adafruit_SSD1306 {
+public:
+    PagedSSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1,
+                 uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+    ~PagedSSD1306();
+
+    bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0,
+               bool reset = true, bool periphBegin = true);
+
+    // Pushes only what changed since the last call
+    void display();
+    // Forces the next display() to resend the whole frame
+    void invalidate() { shadowValid = false; }
+
+    const PagedSSD1306Stats& stats() const { return counters; }
+    void resetStats() { memset(&counters, 0, sizeof(counters)); }
+    void printStats(Print& out) const;
+
+private:
+    void sendRange(uint8_t page, uint8_t col0, uint8_t col1);
+
+    uint8_t* shadow;
+    bool shadowValid;
+    PagedSSD1306Stats counters;
+};
@@ -0,0 +1,202 @@
+#include "RmtDHT.h"
+#include <driver/gpio.h>
+
+#define DHT_TICK_US        1       // RMT clock: 80 MHz APB / 80
+#define DHT_IDLE_US        200     // line high this long = end of frame
+#define DHT_FILTER_TICKS   100     // glitch filter, APB cycles (~1.25 us)
+#define DHT_BIT_THRESHOLD  48      // high pulse: ~27 us = 0, ~70 us = 1
+#define DHT_BIT_MAX_US     100
+
+RmtDHT::RmtDHT(uint8_t pin, uint8_t type, rmt_channel_t channel)
+    : pin(pin), type(type), channel(channel), intervalMs(0), rxBuffer(nullptr),
+      queue(nullptr), task(nullptr), callback(nullptr), lock(portMUX_INITIALIZER_UNLOCKED),
+      numReads(0), numFailures(0), numCacheHits(0), numCoalesced(0), pending(false) {
+    latest = { NAN, NAN, 0, DHT_TIMEOUT };
+}
+
+bool RmtDHT::begin(uint32_t intervalMs) {
+    this->intervalMs = intervalMs ? max(intervalMs, minInterval()) : 0;
+
+    rmt_config_t config = RMT_DEFAULT_CONFIG_RX((gpio_num_t)pin, channel);
+    config.clk_div = 80 * DHT_TICK_US;
+    config.rx_config.filter_en = true;
+    config.rx_config.filter_ticks_thresh = DHT_FILTER_TICKS;
+    config.rx_config.idle_threshold = DHT_IDLE_US / DHT_TICK_US;
+    if (rmt_config(&config) != ESP_OK) return false;
+    if (rmt_driver_install(channel, 512, 0) != ESP_OK) return false;
+    rmt_get_ringbuf_handle(channel, &rxBuffer);
+
+    // Open drain with the input path kept, so the RMT still sees the line
+    // while we drive the start pulse. Idle released (pulled up).
+    gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_pull_mode((gpio_num_t)pin, GPIO_PULLUP_ONLY);
+    gpio_set_level((gpio_num_t)pin, 1);
+
+    queue = xQueueCreate(DHT_QUEUE_LEN, sizeof(DhtSample));
+    if (!queue) return false;
+    return xTaskCreate(taskEntry, "dht", DHT_TASK_STACK, this, DHT_TASK_PRIORITY, &task) == pdPASS;
+}
+
+void RmtDHT::trigger() {
+    if (!task) return;
+    if (pending) {
+        numCoalesced++;
+        return;
+    }
+    pending = true;
+    xTaskNotifyGive(task);
+}
+
+bool RmtDHT::request(uint32_t maxAgeMs) {
+    DhtSample s = last();
+    if (s.status == DHT_OK && millis() - s.timestamp <= maxAgeMs) {
+        numCacheHits++;
+        return true;
+    }
+    trigger();
+    return false;
+}
+
+bool RmtDHT::read(DhtSample& out) {
+    return queue && xQueueReceive(queue, &out, 0) == pdTRUE;
+}
+
+DhtSample RmtDHT::last() const {
+    portENTER_CRITICAL(&lock);
+    DhtSample s = latest;
+    portEXIT_CRITICAL(&lock);
+    return s;
+}
+
+const char* RmtDHT::statusName(DhtStatus s) {
+    switch (s) {
+        case DHT_OK:        return "OK";
+        case DHT_TIMEOUT:   return "timeout";
+        case DHT_BAD_FRAME: return "bad frame";
+        case DHT_CHECKSUM:  return "checksum";
+        default:            return "?";
+    }
+}
+
+void RmtDHT::taskEntry(void* arg) {
+    static_cast<RmtDHT*>(arg)->run();
+}
+
+void RmtDHT::run() {
+    uint32_t lastRead = millis() - minInterval();   // first sample right away
+    uint32_t retryAt = 0;
+    bool retry = false;
+
+    for (;;) {
+        // Sleep until the next periodic sample, a retry or trigger()
+        TickType_t wait = portMAX_DELAY;
+        if (intervalMs || retry) {
+            uint32_t due = retry ? retryAt : lastRead + intervalMs;
+            int32_t left = (int32_t)(due - millis());
+            wait = left > 0 ? pdMS_TO_TICKS(left) : 0;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        // The sensor needs its rest between conversions, trigger or not
+        int32_t rest = (int32_t)(lastRead + minInterval() - millis());
+        if (rest > 0) vTaskDelay(pdMS_TO_TICKS(rest));
+
+        // Whatever woke us, this read answers every trigger so far. The
+        // notification goes first: a trigger() landing in between sees
+        // pending still set and is folded into this read; one after the
+        // clear notifies again and gets a read of its own.
+        ulTaskNotifyTake(pdTRUE, 0);
+        pending = false;
+        DhtSample s = acquire();
+        lastRead = s.timestamp;
+        numReads++;
+
+        // A failed read is retried once after the minimum interval
+        retry = s.status != DHT_OK && !retry;
+        retryAt = lastRead + minInterval();
+
+        if (s.status == DHT_OK) {
+            portENTER_CRITICAL(&lock);
+            latest = s;
+            portEXIT_CRITICAL(&lock);
+        } else {
+            numFailures++;
+        }
+
+        if (xQueueSend(queue, &s, 0) != pdTRUE) {
+            DhtSample dropped;
+            xQueueReceive(queue, &dropped, 0);   // keep the newest
+            xQueueSend(queue, &s, 0);
+        }
+        if (callback) callback(s);
+    }
+}
+
+DhtSample RmtDHT::acquire() {
+    DhtSample s = { NAN, NAN, 0, DHT_TIMEOUT };
+    gpio_num_t gpio = (gpio_num_t)pin;
+
+    // Drop anything left over from a previous, aborted capture
+    size_t size;
+    void* stale;
+    while ((stale = xRingbufferReceive(rxBuffer, &size, 0))) vRingbufferReturnItem(rxBuffer, stale);
+
+    // Start pulse: >= 18 ms for DHT11, >= 1 ms for DHT22. The task sleeps.
+    gpio_set_level(gpio, 0);
+    vTaskDelay(pdMS_TO_TICKS(type == DHT11 ? 20 : 2));
+
+    // Receiver on before the release, so the capture starts at that edge
+    rmt_rx_start(channel, true);
+    gpio_set_level(gpio, 1);
+    s.timestamp = millis();
+
+    rmt_item32_t* items = (rmt_item32_t*)xRingbufferReceive(rxBuffer, &size, pdMS_TO_TICKS(DHT_REPLY_TIMEOUT));
+    rmt_rx_stop(channel);
+    if (!items) return s;
+
+    uint8_t data[5];
+    s.status = decode(items, size / sizeof(rmt_item32_t), data);
+    vRingbufferReturnItem(rxBuffer, items);
+    if (s.status != DHT_OK) return s;
+
+    if (type == DHT11) {
+        s.humidity = data[0] + data[1] * 0.1f;
+        s.temperature = (data[2] & 0x7F) + data[3] * 0.1f;
+        if (data[2] & 0x80) s.temperature = -s.temperature;
+    } else {
+        s.humidity = ((data[0] << 8) | data[1]) * 0.1f;
+        s.temperature = (((data[2] & 0x7F) << 8) | data[3]) * 0.1f;
+        if (data[2] & 0x80) s.temperature = -s.temperature;
+    }
+    return s;
+}
+
+// The capture is: host release (high), 80 us low + 80 us high response,
+// then 40 x (50 us low, 27/70 us high), then a final low. Only the high
+// durations carry data, so the last 40 high pulses are the payload.
+DhtStatus RmtDHT::decode(const rmt_item32_t* items, size_t n, uint8_t data[5]) const {
+    uint16_t highs[48];
+    uint8_t count = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const uint16_t dur[2] = { (uint16_t)items[i].duration0, (uint16_t)items[i].duration1 };
+        const uint8_t lvl[2] = { (uint8_t)items[i].level0, (uint8_t)items[i].level1 };
+        for (uint8_t k = 0; k < 2; k++) {
+            if (dur[k] == 0) { i = n; break; }   // end marker
+            if (!lvl[k]) continue;
+            if (count == sizeof(highs) / sizeof(highs[0])) return DHT_BAD_FRAME;
+            highs[count++] = dur[k] * DHT_TICK_US;
+        }
+    }
+    if (count < 40) return count == 0 ? DHT_TIMEOUT : DHT_BAD_FRAME;
+
+    memset(data, 0, 5);
+    const uint16_t* bits = highs + count - 40;
+    for (uint8_t b = 0; b < 40; b++) {
+        if (bits[b] > DHT_BIT_MAX_US) return DHT_BAD_FRAME;
+        data[b / 8] = (data[b / 8] << 1) | (bits[b] > DHT_BIT_THRESHOLD);
+    }
+
+    uint8_t sum = data[0] + data[1] + data[2] + data[3];
+    return sum == data[4] ? DHT_OK : DHT_CHECKSUM;
+}
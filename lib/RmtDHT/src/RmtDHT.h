@@ -0,0 +1,99 @@
+// Interrupt-free DHT11/DHT22 driver on the ESP32 RMT peripheral
+// The bit-banged DHT library busy-waits on the data line with interrupts
+// off for ~5 ms per read. Here a background task sends the start pulse
+// (sleeping, not spinning, while the line is held low), the RMT receiver
+// timestamps every edge of the reply in hardware, and the task decodes the
+// captured pulse train. Finished samples are queued with the millis() of
+// their capture; loop() only ever polls read(), which never blocks.
+
+#pragma once
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include <freertos/queue.h>
+
+#ifndef DHT11
+#define DHT11 11
+#endif
+#ifndef DHT22
+#define DHT22 22
+#endif
+
+#define DHT_QUEUE_LEN      4       // samples kept for read(); oldest dropped
+#define DHT_TASK_STACK     3072
+#define DHT_TASK_PRIORITY  2
+#define DHT_REPLY_TIMEOUT  20      // ms to wait for the frame after the start pulse
+
+enum DhtStatus : uint8_t {
+    DHT_OK = 0,
+    DHT_TIMEOUT,      // no (complete) reply captured
+    DHT_BAD_FRAME,    // fewer than 40 data bits or an out-of-spec pulse
+    DHT_CHECKSUM
+};
+
+struct DhtSample {
+    float temperature;   // degrees C, NAN unless status == DHT_OK
+    float humidity;      // %RH, NAN unless status == DHT_OK
+    uint32_t timestamp;  // millis() when the frame was captured
+    DhtStatus status;
+};
+
+// Called from the driver task, not from loop(); keep it short
+typedef void (*DhtCallback)(const DhtSample& sample);
+
+class RmtDHT {
+public:
+    RmtDHT(uint8_t pin, uint8_t type, rmt_channel_t channel = RMT_CHANNEL_0);
+
+    // Installs the RMT receiver and starts the acquisition task. With
+    // intervalMs > 0 the sensor is sampled periodically; with 0 only on
+    // trigger(). The interval is clamped to the sensor's minimum.
+    bool begin(uint32_t intervalMs = 2000);
+
+    // Requests a sample as soon as the sensor's minimum interval allows.
+    // Triggers arriving before that read starts are folded into it.
+    void trigger();
+
+    // On-demand read: true if last() is at most maxAgeMs old, so the caller
+    // can use it as is. Otherwise triggers a read (coalesced as above) whose
+    // sample arrives through read() like any other.
+    bool request(uint32_t maxAgeMs);
+
+    // Next queued sample, false if none is waiting. Never blocks.
+    bool read(DhtSample& out);
+
+    // Most recent successful sample (status DHT_TIMEOUT before the first one)
+    DhtSample last() const;
+
+    void setCallback(DhtCallback cb) { callback = cb; }
+    uint32_t minInterval() const { return type == DHT11 ? 1000 : 2000; }
+
+    uint32_t reads() const { return numReads; }
+    uint32_t failures() const { return numFailures; }
+    uint32_t cacheHits() const { return numCacheHits; }   // request() served by last()
+    uint32_t coalesced() const { return numCoalesced; }   // triggers folded into a pending read
+
+    static const char* statusName(DhtStatus s);
+
+private:
+    static void taskEntry(void* arg);
+    void run();
+    DhtSample acquire();
+    DhtStatus decode(const rmt_item32_t* items, size_t n, uint8_t data[5]) const;
+
+    uint8_t pin;
+    uint8_t type;
+    rmt_channel_t channel;
+    uint32_t intervalMs;
+    RingbufHandle_t rxBuffer;
+    QueueHandle_t queue;
+    TaskHandle_t task;
+    DhtCallback callback;
+    mutable portMUX_TYPE lock;
+    DhtSample latest;
+    volatile uint32_t numReads;
+    volatile uint32_t numFailures;
+    volatile uint32_t numCacheHits;
+    volatile uint32_t numCoalesced;
+    volatile bool pending;   // a trigger() is waiting for its read
+};
@@ -0,0 +1,175 @@
+// Host cost comparison for SensorPipeline (not an Arduino sketch)
+//
+//   g++ -O2 -std=c++11 -I../../src HostPipelineBenchmark.cpp -o bench && ./bench
+//
+// Runs the same node - DHT-like source, light join, Serial line, OLED
+// layout, a rate-limited upload - twice over a recording display and
+// stream:
+//   hand     - written out inline, the way the sketches' loop() did it
+//   pipeline - makePipeline(...) from the same stages
+// Both must produce identical output; the per-frame times should match
+// within noise, since the pipeline compiles down to the same calls.
+
+#include <SensorPipeline.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+static const uint32_t FRAMES = 2000000;
+static const int REPEAT = 5;
+
+// Hashes everything "drawn" or "printed" so the work cannot be optimised out
+struct Recorder {
+    uint32_t hash = 2166136261u;
+
+    void mix(const char* s) {
+        while (*s) hash = (hash ^ (uint8_t)*s++) * 16777619u;
+    }
+    void mix(uint32_t v) { hash = (hash ^ v) * 16777619u; }
+
+    void clearDisplay() { mix(1); }
+    void setTextSize(uint8_t s) { mix(s); }
+    void setTextColor(uint16_t c) { mix(c); }
+    void setCursor(int16_t x, int16_t y) { mix((uint32_t)x << 16 | (uint16_t)y); }
+    void print(const char* s) { mix(s); }
+    void print(unsigned v) { mix(v); }
+    void print(float v, int digits) {
+        char b[16];
+        snprintf(b, sizeof(b), "%.*f", digits, v);
+        mix(b);
+    }
+    void println(const char* s) { mix(s); }
+    void display() { mix(2); }
+};
+
+struct FakeSource {
+    uint32_t n;
+
+    bool poll(SensorFrame& f) {
+        n++;
+        f.timestamp = n * 1000;
+        if (n % 50 == 0) {
+            f.error = "timeout";
+        } else {
+            f.temperature = 20.0f + (n % 100) * 0.1f;
+            f.humidity = 40.0f + (n % 37) * 0.5f;
+            f.fields |= FRAME_TEMP | FRAME_HUM;
+        }
+        return true;
+    }
+};
+
+struct FakeLight {
+    bool process(SensorFrame& f) {
+        f.counts = 1200 + f.timestamp % 17;
+        f.volts = f.counts * 3.3f / 4095;
+        f.lux = f.counts * 0.25f;
+        f.fields |= FRAME_LIGHT;
+        return true;
+    }
+};
+
+static Recorder serialOut, oled, cloud;
+
+static void upload(const SensorFrame& f) {
+    cloud.mix((uint32_t)(f.temperature * 10));
+    cloud.mix((uint32_t)(f.humidity * 10));
+}
+
+// The same node written out by hand
+static void handStep(FakeSource& src, uint32_t& lastUpload, bool& uploaded) {
+    SensorFrame f = {};
+    if (!src.poll(f)) return;
+    FakeLight().process(f);
+
+    char line[SENSOR_LINE_LEN];
+    formatFrame(f, line, sizeof(line));
+    serialOut.println(line);
+
+    oled.clearDisplay();
+    oled.setTextSize(1);
+    oled.setTextColor(1);
+    oled.setCursor(0, 0);
+    oled.print("Node");
+    int16_t y = 16;
+    if (f.error) {
+        oled.setCursor(0, y);
+        oled.print("Error: ");
+        oled.print(f.error);
+        y += 10;
+    }
+    if (f.has(FRAME_TEMP)) {
+        oled.setCursor(0, y);
+        oled.print("Temp: ");
+        oled.print(f.temperature, 1);
+        oled.print(" C");
+        y += 10;
+    }
+    if (f.has(FRAME_HUM)) {
+        oled.setCursor(0, y);
+        oled.print("Hum:  ");
+        oled.print(f.humidity, 1);
+        oled.print(" %");
+        y += 10;
+    }
+    oled.setCursor(0, y);
+    oled.print("LDR:  ");
+    oled.print(f.counts);
+    oled.print(" / ");
+    oled.print(f.volts, 2);
+    oled.print("V");
+    oled.display();
+
+    if (!f.has(FRAME_TEMP | FRAME_HUM)) return;
+    if (uploaded && f.timestamp - lastUpload < 10000) return;
+    uploaded = true;
+    lastUpload = f.timestamp;
+    upload(f);
+}
+
+template <typename F>
+static double bestSeconds(F fn) {
+    double best = 1e9;
+    for (int r = 0; r < REPEAT; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+int main() {
+    uint32_t hashes[2][3];
+
+    double hand = bestSeconds([&] {
+        serialOut = oled = cloud = Recorder();
+        FakeSource src = { 0 };
+        uint32_t lastUpload = 0;
+        bool uploaded = false;
+        for (uint32_t i = 0; i < FRAMES; i++) handStep(src, lastUpload, uploaded);
+        hashes[0][0] = serialOut.hash;
+        hashes[0][1] = oled.hash;
+        hashes[0][2] = cloud.hash;
+    });
+
+    double pipe = bestSeconds([&] {
+        serialOut = oled = cloud = Recorder();
+        auto node = makePipeline(FakeSource{ 0 }, FakeLight(),
+                                 printSink(serialOut), oledSink(oled, "Node"),
+                                 requireFields(FRAME_TEMP | FRAME_HUM),
+                                 every(10000, callSink(upload)));
+        for (uint32_t i = 0; i < FRAMES; i++) node.step();
+        hashes[1][0] = serialOut.hash;
+        hashes[1][1] = oled.hash;
+        hashes[1][2] = cloud.hash;
+    });
+
+    bool same = memcmp(hashes[0], hashes[1], sizeof(hashes[0])) == 0;
+    printf("%u frames, best of %d\n", (unsigned)FRAMES, REPEAT);
+    printf("  hand      %7.1f ns/frame\n", hand * 1e9 / FRAMES);
+    printf("  pipeline  %7.1f ns/frame  (%+.1f%%)\n", pipe * 1e9 / FRAMES, (pipe / hand - 1) * 100);
+    printf("  output    %s\n", same ? "identical" : "DIFFERENT");
+    return same ? 0 : 1;
+}
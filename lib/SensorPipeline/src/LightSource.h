@@ -0,0 +1,23 @@
+// Pipeline stage for the LdrAdc driver
+// withLight() adds the latest filtered LDR reading to every frame. Kept
+// apart from SensorSources.h: including it links the I2S ADC sampler.
+
+#pragma once
+
+#include <SensorPipeline.h>
+#include <LdrAdc.h>
+
+struct WithLight {
+    LdrAdc* ldr;
+
+    bool process(SensorFrame& f) {
+        LdrReading r = ldr->last();
+        f.counts = r.counts();
+        f.volts = r.volts();
+        f.lux = r.lux();
+        f.fields |= FRAME_LIGHT;
+        return true;
+    }
+};
+
+inline WithLight withLight(LdrAdc& ldr) { return WithLight{ &ldr }; }
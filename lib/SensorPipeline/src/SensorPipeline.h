@@ -0,0 +1,267 @@
+// Compile-time sensor node pipeline
+// A node is one source followed by a chain of stages (transforms and
+// sinks), all given as template parameters and stored by value:
+//
+//   auto node = makePipeline(dhtSource(dht), withLight(ldr),
+//                            printSink(Serial), oledSink(display, "Hello IoT"));
+//   void loop() { node.step(); }
+//
+// Every call is resolved at compile time, so step() inlines into the same
+// straight-line code a hand-written loop() would be - no virtual dispatch,
+// no heap. All sinks share formatFrame(), so every node prints the same
+// way; the cadence is the source's own (e.g. the RmtDHT interval).
+//
+// Plain C++ with no Arduino dependencies (the driver adaptors live in
+// SensorSources.h and LightSource.h), so the core also builds in examples/HostPipelineBenchmark.
+//
+// Stage interface:  bool process(SensorFrame& f)  - false ends this frame
+// Source interface: bool poll(SensorFrame& f)     - false if nothing new
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef SENSOR_PIPELINE_PROFILE
+#include <Arduino.h>
+#endif
+
+// SensorFrame::fields bits
+#define FRAME_TEMP   0x01
+#define FRAME_HUM    0x02
+#define FRAME_LIGHT  0x04
+
+#define SENSOR_LINE_LEN 96   // formatFrame() output, one line
+
+struct SensorFrame {
+    uint32_t timestamp;      // millis() of the capture
+    uint8_t fields;          // FRAME_* bits whose values below are valid
+    const char* error;       // source status text, nullptr when OK
+    float temperature;       // degrees C
+    float humidity;          // %RH
+    float lux;
+    float volts;             // LDR divider voltage
+    uint16_t counts;         // LDR filtered ADC counts
+
+    bool has(uint8_t mask) const { return (fields & mask) == mask; }
+};
+
+// "Temp: 23.4 C | Hum: 41.0 % | Light: 312.5 lx (1.21 V)"; an error is
+// reported first and the fields that are still valid follow
+inline size_t formatFrame(const SensorFrame& f, char* buf, size_t len) {
+    size_t n = 0;
+    auto put = [&](int r) { if (r > 0) n = n + r < len ? n + r : len - 1; };
+
+    buf[0] = '\0';
+    if (f.error) put(snprintf(buf + n, len - n, "Sensor error (%s)", f.error));
+    if (f.has(FRAME_TEMP)) {
+        put(snprintf(buf + n, len - n, "%sTemp: %.1f C", n ? " | " : "", f.temperature));
+    }
+    if (f.has(FRAME_HUM)) {
+        put(snprintf(buf + n, len - n, "%sHum: %.1f %%", n ? " | " : "", f.humidity));
+    }
+    if (f.has(FRAME_LIGHT)) {
+        put(snprintf(buf + n, len - n, "%sLight: %.1f lx (%.2f V)", n ? " | " : "", f.lux, f.volts));
+    }
+    return n;
+}
+
+// ---------- Chain ----------
+
+template <typename... Stages>
+struct StageChain;
+
+template <>
+struct StageChain<> {
+    bool process(SensorFrame&) { return true; }
+};
+
+template <typename Head, typename... Tail>
+struct StageChain<Head, Tail...> {
+    StageChain(const Head& head, const Tail&... tail) : head(head), tail(tail...) {}
+
+    bool process(SensorFrame& f) { return head.process(f) && tail.process(f); }
+
+    Head head;
+    StageChain<Tail...> tail;
+};
+
+#ifdef SENSOR_PIPELINE_PROFILE
+struct PipelineProfile {
+    uint32_t frames;
+    uint32_t lastCycles;   // stages only, excluding the source poll
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+
+    uint32_t avgCycles() const { return frames ? totalCycles / frames : 0; }
+};
+#endif
+
+template <typename Source, typename... Stages>
+class SensorPipeline {
+public:
+    SensorPipeline(const Source& source, const Stages&... stages)
+        : source(source), stages(stages...) {}
+
+    // Runs the stages once if the source has a new frame. Never blocks.
+    bool step() {
+        SensorFrame f = {};
+        if (!source.poll(f)) return false;
+#ifdef SENSOR_PIPELINE_PROFILE
+        uint32_t start = ESP.getCycleCount();
+        stages.process(f);
+        uint32_t c = ESP.getCycleCount() - start;
+        prof.frames++;
+        prof.lastCycles = c;
+        prof.totalCycles += c;
+        if (c > prof.maxCycles) prof.maxCycles = c;
+#else
+        stages.process(f);
+#endif
+        return true;
+    }
+
+    Source& input() { return source; }
+
+#ifdef SENSOR_PIPELINE_PROFILE
+    const PipelineProfile& profile() const { return prof; }
+#endif
+
+private:
+    Source source;
+    StageChain<Stages...> stages;
+#ifdef SENSOR_PIPELINE_PROFILE
+    PipelineProfile prof = {};
+#endif
+};
+
+template <typename Source, typename... Stages>
+SensorPipeline<Source, Stages...> makePipeline(const Source& source, const Stages&... stages) {
+    return SensorPipeline<Source, Stages...>(source, stages...);
+}
+
+// ---------- Transforms ----------
+
+// Ends the frame unless all of `mask` is valid (put sinks that should see
+// errors before it)
+struct RequireFields {
+    uint8_t mask;
+
+    bool process(SensorFrame& f) const { return f.has(mask); }
+};
+
+inline RequireFields requireFields(uint8_t mask) { return RequireFields{ mask }; }
+
+// Runs the wrapped stage at most once per periodMs; the chain always goes on
+template <typename Stage>
+struct Every {
+    Stage stage;
+    uint32_t periodMs;
+    uint32_t last;
+    bool started;
+
+    bool process(SensorFrame& f) {
+        if (started && f.timestamp - last < periodMs) return true;
+        started = true;
+        last = f.timestamp;
+        stage.process(f);
+        return true;
+    }
+};
+
+template <typename Stage>
+Every<Stage> every(uint32_t periodMs, const Stage& stage) {
+    return Every<Stage>{ stage, periodMs, 0, false };
+}
+
+// ---------- Sinks ----------
+
+// One formatFrame() line per frame to a Serial-like stream
+template <typename Out>
+struct PrintSink {
+    Out* out;
+
+    bool process(SensorFrame& f) {
+        char line[SENSOR_LINE_LEN];
+        formatFrame(f, line, sizeof(line));
+        out->println(line);
+        return true;
+    }
+};
+
+template <typename Out>
+PrintSink<Out> printSink(Out& out) { return PrintSink<Out>{ &out }; }
+
+// Title on top, one 10 px row per valid field, optional footer at the bottom
+template <typename Display>
+struct OledSink {
+    Display* display;
+    const char* title;
+    const char* footer;
+
+    bool process(SensorFrame& f) {
+        Display& d = *display;
+        d.clearDisplay();
+        d.setTextSize(1);
+        d.setTextColor(1);   // SSD1306_WHITE
+        d.setCursor(0, 0);
+        d.print(title);
+
+        int16_t y = 16;
+        if (f.error) {
+            d.setCursor(0, y);
+            d.print("Error: ");
+            d.print(f.error);
+            y += 10;
+        }
+        if (f.has(FRAME_TEMP)) {
+            d.setCursor(0, y);
+            d.print("Temp: ");
+            d.print(f.temperature, 1);
+            d.print(" C");
+            y += 10;
+        }
+        if (f.has(FRAME_HUM)) {
+            d.setCursor(0, y);
+            d.print("Hum:  ");
+            d.print(f.humidity, 1);
+            d.print(" %");
+            y += 10;
+        }
+        if (f.has(FRAME_LIGHT)) {
+            d.setCursor(0, y);
+            d.print("LDR:  ");
+            d.print(f.counts);
+            d.print(" / ");
+            d.print(f.volts, 2);
+            d.print("V");
+        }
+        if (footer) {
+            d.setCursor(0, 56);
+            d.print(footer);
+        }
+        d.display();
+        return true;
+    }
+};
+
+template <typename Display>
+OledSink<Display> oledSink(Display& display, const char* title, const char* footer = nullptr) {
+    return OledSink<Display>{ &display, title, footer };
+}
+
+// Calls fn(const SensorFrame&); with a lambda the call inlines
+template <typename F>
+struct CallSink {
+    F fn;
+
+    bool process(SensorFrame& f) {
+        fn(static_cast<const SensorFrame&>(f));
+        return true;
+    }
+};
+
+template <typename F>
+CallSink<F> callSink(F fn) { return CallSink<F>{ fn }; }
@@ -0,0 +1,29 @@
+// Pipeline adaptor for the RmtDHT driver
+// dhtSource() turns RmtDHT samples into frames. The LDR stage is in
+// LightSource.h, so that DHT-only sketches do not pull in LdrAdc.
+// See SensorPipeline.h.
+
+#pragma once
+
+#include <SensorPipeline.h>
+#include <RmtDHT.h>
+
+struct DhtSource {
+    RmtDHT* dht;
+
+    bool poll(SensorFrame& f) {
+        DhtSample s;
+        if (!dht->read(s)) return false;
+        f.timestamp = s.timestamp;
+        if (s.status == DHT_OK) {
+            f.temperature = s.temperature;
+            f.humidity = s.humidity;
+            f.fields |= FRAME_TEMP | FRAME_HUM;
+        } else {
+            f.error = RmtDHT::statusName(s.status);
+        }
+        return true;
+    }
+};
+
+inline DhtSource dhtSource(RmtDHT& dht) { return DhtSource{ &dht }; }
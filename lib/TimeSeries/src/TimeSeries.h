@@ -0,0 +1,137 @@
+// Fixed-footprint multi-resolution time series
+// Every sample goes into three rings at once: the last RAW samples as-is,
+// plus per-minute and per-hour min/max/avg buckets. A bucket's slot is
+// (t / width) % N, so appending and finding the bucket for any time are a
+// division and an index, and old data is overwritten in place - no
+// allocation, no shifting, no compaction pass.
+//
+// Times are caller-defined seconds (millis() / 1000 on nodes without a wall
+// clock) and must not go backwards. Not thread-safe: append and query from
+// the same task, as the sketches do from loop().
+
+#pragma once
+
+#include <Arduino.h>
+
+#define TS_MINUTE_SECONDS  60UL
+#define TS_HOUR_SECONDS    3600UL
+
+struct TsSample {
+    uint32_t t;
+    float value;
+};
+
+struct TsAggregate {
+    uint32_t start;    // first second of the bucket
+    float min;
+    float max;
+    float sum;
+    uint16_t count;
+
+    float avg() const { return count ? sum / count : NAN; }
+
+    void add(float v) {
+        if (!count || v < min) min = v;
+        if (!count || v > max) max = v;
+        sum += v;
+        count++;
+    }
+    void merge(const TsAggregate& o) {
+        if (!o.count) return;
+        if (!count || o.min < min) min = o.min;
+        if (!count || o.max > max) max = o.max;
+        sum += o.sum;
+        count += o.count;
+    }
+};
+
+enum TsTier : uint8_t {
+    TS_MINUTE = 0,
+    TS_HOUR
+};
+
+template <uint16_t RAW, uint16_t MINUTES = 60, uint16_t HOURS = 24>
+class TimeSeries {
+    static_assert(RAW > 0 && MINUTES > 0 && HOURS > 0, "TimeSeries tiers need at least one slot");
+
+public:
+    TimeSeries() : rawHead(0), rawCount(0) { clear(); }
+
+    void clear() {
+        rawHead = 0;
+        rawCount = 0;
+        for (uint16_t i = 0; i < MINUTES; i++) minutes[i].count = 0;
+        for (uint16_t i = 0; i < HOURS; i++) hours[i].count = 0;
+    }
+
+    void add(uint32_t t, float value) {
+        if (isnan(value)) return;
+        raws[rawHead] = { t, value };
+        rawHead = (rawHead + 1) % RAW;
+        if (rawCount < RAW) rawCount++;
+
+        accumulate(minutes, MINUTES, TS_MINUTE_SECONDS, t, value);
+        accumulate(hours, HOURS, TS_HOUR_SECONDS, t, value);
+    }
+
+    // ---------- Raw tier ----------
+    uint16_t size() const { return rawCount; }
+    // age 0 = newest; age must be < size()
+    const TsSample& raw(uint16_t age) const { return raws[(rawHead + RAW - 1 - age) % RAW]; }
+    const TsSample* latest() const { return rawCount ? &raw(0) : nullptr; }
+
+    // ---------- Aggregate tiers ----------
+    static uint32_t width(TsTier tier) { return tier == TS_MINUTE ? TS_MINUTE_SECONDS : TS_HOUR_SECONDS; }
+    static uint16_t capacity(TsTier tier) { return tier == TS_MINUTE ? MINUTES : HOURS; }
+
+    // The bucket holding time t, or nullptr if it is empty or already overwritten
+    const TsAggregate* bucket(TsTier tier, uint32_t t) const {
+        uint32_t w = width(tier);
+        const TsAggregate& b = slots(tier)[(t / w) % capacity(tier)];
+        return b.count && b.start == t - t % w ? &b : nullptr;
+    }
+
+    // Calls fn(const TsAggregate&) for each retained non-empty bucket
+    // overlapping [from, to], oldest first; returns how many were visited.
+    // At most capacity(tier) buckets are looked at, whatever the range.
+    template <typename F>
+    uint16_t range(TsTier tier, uint32_t from, uint32_t to, F fn) const {
+        if (to < from) return 0;
+        uint32_t w = width(tier);
+        uint32_t first = from / w, last = to / w;
+        if (last - first >= capacity(tier)) first = last - capacity(tier) + 1;
+        uint16_t visited = 0;
+        for (uint32_t b = first; b <= last; b++) {
+            const TsAggregate* agg = bucket(tier, b * w);
+            if (agg) {
+                fn(*agg);
+                visited++;
+            }
+        }
+        return visited;
+    }
+
+    // min/max/avg over [from, to] at the tier's resolution
+    TsAggregate summary(TsTier tier, uint32_t from, uint32_t to) const {
+        TsAggregate total = { from - from % width(tier), 0, 0, 0, 0 };
+        range(tier, from, to, [&total](const TsAggregate& a) { total.merge(a); });
+        return total;
+    }
+
+private:
+    const TsAggregate* slots(TsTier tier) const { return tier == TS_MINUTE ? minutes : hours; }
+
+    static void accumulate(TsAggregate* ring, uint16_t n, uint32_t w, uint32_t t, float v) {
+        uint32_t start = t - t % w;
+        TsAggregate& b = ring[(t / w) % n];
+        if (b.count && b.start > start) return;      // late sample for an overwritten bucket
+        if (!b.count || b.start != start) b = { start, v, v, 0, 0 };
+        b.add(v);
+    }
+
+    TsSample raws[RAW];
+    uint16_t rawHead;
+    uint16_t rawCount;
+    TsAggregate minutes[MINUTES];
+    TsAggregate hours[HOURS];
+};
@@ -0,0 +1,276 @@
+#include "TimerScheduler.h"
+
+TimerScheduler::TimerScheduler(timer_group_t group, timer_idx_t index)
+    : group(group), index(index), task(nullptr), lock(portMUX_INITIALIZER_UNLOCKED),
+      heapSize(0), numIsr(0), isrMaxCycles(0) {
+    memset(slots, 0, sizeof(slots));
+    for (uint8_t i = 0; i < TS_MAX_TIMERS; i++) slots[i].heapPos = -1;
+}
+
+bool TimerScheduler::begin() {
+    if (xTaskCreate(taskEntry, "timers", TS_TASK_STACK, this, TS_TASK_PRIORITY, &task) != pdPASS) return false;
+
+    timer_config_t config = {};
+    config.divider = 80;                   // 80 MHz APB -> 1 us per count
+    config.counter_dir = TIMER_COUNT_UP;
+    config.counter_en = TIMER_PAUSE;
+    config.alarm_en = TIMER_ALARM_EN;
+    config.auto_reload = TIMER_AUTORELOAD_DIS;
+    config.intr_type = TIMER_INTR_LEVEL;
+    if (timer_init(group, index, &config) != ESP_OK) return false;
+
+    timer_set_counter_value(group, index, 0);
+    timer_set_alarm_value(group, index, UINT64_MAX);   // nothing scheduled yet
+    timer_enable_intr(group, index);
+    if (timer_isr_callback_add(group, index, onAlarm, this, ESP_INTR_FLAG_IRAM) != ESP_OK) return false;
+    return timer_start(group, index) == ESP_OK;
+}
+
+int8_t TimerScheduler::every(uint32_t periodUs, TimerCallback cb, void* arg, TimerDispatch dispatch) {
+    return periodUs >= TS_MIN_PERIOD_US ? add(periodUs, periodUs, cb, arg, dispatch) : -1;
+}
+
+int8_t TimerScheduler::after(uint32_t delayUs, TimerCallback cb, void* arg, TimerDispatch dispatch) {
+    return add(delayUs, 0, cb, arg, dispatch);
+}
+
+int8_t TimerScheduler::add(uint32_t delayUs, uint32_t periodUs, TimerCallback cb, void* arg,
+                           TimerDispatch dispatch) {
+    if (!task || !cb) return -1;
+
+    portENTER_CRITICAL(&lock);
+    int8_t id = -1;
+    for (uint8_t i = 0; i < TS_MAX_TIMERS; i++) {
+        if (!slots[i].inUse) {
+            id = i;
+            break;
+        }
+    }
+    if (id >= 0) {
+        Slot& s = slots[id];
+        memset(&s, 0, sizeof(s));
+        s.cb = cb;
+        s.arg = arg;
+        s.periodUs = periodUs;
+        s.dispatch = dispatch;
+        s.inUse = true;
+        uint64_t now = counter();
+        s.deadline = now + delayUs;
+        heapPush(id);
+        if (heap[0] == id) armFor(s.deadline, now);
+    }
+    portEXIT_CRITICAL(&lock);
+    return id;
+}
+
+bool TimerScheduler::cancel(int8_t id) {
+    if (id < 0 || id >= TS_MAX_TIMERS) return false;
+
+    portENTER_CRITICAL(&lock);
+    Slot& s = slots[id];
+    bool was = s.inUse;
+    if (s.heapPos >= 0) {
+        bool first = s.heapPos == 0;
+        heapRemove(s.heapPos);
+        if (first && heapSize) armFor(slots[heap[0]].deadline, counter());
+        // An emptied heap leaves the old alarm set; it finds nothing due
+    }
+    s.inUse = false;
+    s.pending = 0;
+    portEXIT_CRITICAL(&lock);
+    return was;
+}
+
+TimerStats TimerScheduler::stats(int8_t id) const {
+    TimerStats out = { 0, 0, 0, 0, 0, 0 };
+    if (id < 0 || id >= TS_MAX_TIMERS) return out;
+
+    portENTER_CRITICAL(&lock);
+    Slot s = slots[id];
+    portEXIT_CRITICAL(&lock);
+
+    uint32_t mhz = getCpuFrequencyMhz();
+    out.runs = s.runs;
+    out.missed = s.missed;
+    out.jitterMaxUs = s.jitterMaxUs;
+    out.jitterAvgUs = s.runs ? s.jitterSumUs / s.runs : 0;
+    out.runMaxNs = (uint64_t)s.runMaxCycles * 1000 / mhz;
+    out.runAvgNs = s.runs ? s.runSumCycles * 1000 / mhz / s.runs : 0;
+    return out;
+}
+
+uint32_t TimerScheduler::isrMaxNs() const {
+    return (uint64_t)isrMaxCycles * 1000 / getCpuFrequencyMhz();
+}
+
+uint64_t TimerScheduler::nowUs() const {
+    portENTER_CRITICAL(&lock);
+    uint64_t now = counter();
+    portEXIT_CRITICAL(&lock);
+    return now;
+}
+
+uint64_t IRAM_ATTR TimerScheduler::counter() const {
+    return timer_group_get_counter_value_in_isr(group, index);
+}
+
+// A deadline that is (nearly) here already is left to the ISR, which spins
+// for it: an alarm set into the past would not fire until the count wraps
+void IRAM_ATTR TimerScheduler::armFor(uint64_t deadline, uint64_t now) {
+    uint64_t earliest = now + TS_MIN_LEAD_US;
+    timer_group_set_alarm_value_in_isr(group, index, deadline > earliest ? deadline : earliest);
+    timer_group_enable_alarm_in_isr(group, index);
+}
+
+bool IRAM_ATTR TimerScheduler::onAlarm(void* arg) {
+    return static_cast<TimerScheduler*>(arg)->dispatchDue();
+}
+
+bool IRAM_ATTR TimerScheduler::dispatchDue() {
+    uint32_t isrStart = ESP.getCycleCount();
+    uint32_t wake = 0;
+
+    portENTER_CRITICAL_ISR(&lock);
+    uint64_t now = counter();
+    for (uint8_t n = 0; heapSize && n < 2 * TS_MAX_TIMERS; n++) {   // bounded: never stuck here
+        uint8_t id = heap[0];
+        Slot& s = slots[id];
+        if (s.deadline > now + TS_MIN_LEAD_US) break;
+        while (now < s.deadline) now = counter();
+
+        uint64_t deadline = s.deadline;
+        if (s.periodUs) {
+            // Drift-free; after an overrun skip to the next future period.
+            // 32-bit division: the Xtensa does it in hardware, in IRAM.
+            s.deadline += s.periodUs;
+            if (s.deadline <= now) {
+                uint32_t behind = (uint32_t)(now - s.deadline) / s.periodUs + 1;
+                s.deadline += (uint64_t)behind * s.periodUs;
+                s.missed += behind;
+            }
+            heapSiftDown(0);
+        } else {
+            heapRemove(0);
+        }
+
+        if (s.dispatch == TIMER_IN_ISR) {
+            uint32_t jitter = (uint32_t)(now - deadline);
+            uint32_t t0 = ESP.getCycleCount();
+            s.cb(s.arg);
+            uint32_t cycles = ESP.getCycleCount() - t0;
+            s.runs++;
+            s.jitterSumUs += jitter;
+            if (jitter > s.jitterMaxUs) s.jitterMaxUs = jitter;
+            s.runSumCycles += cycles;
+            if (cycles > s.runMaxCycles) s.runMaxCycles = cycles;
+            if (!s.periodUs) s.inUse = false;
+        } else {
+            if (s.pending) s.missed++;   // the task has not caught up: one run for both
+            else s.due = deadline;
+            s.pending = 1;
+            wake |= 1UL << id;
+        }
+        now = counter();
+    }
+    if (heapSize) armFor(slots[heap[0]].deadline, now);
+
+    uint32_t cycles = ESP.getCycleCount() - isrStart;
+    numIsr++;
+    if (cycles > isrMaxCycles) isrMaxCycles = cycles;
+    portEXIT_CRITICAL_ISR(&lock);
+
+    BaseType_t woken = pdFALSE;
+    if (wake) xTaskNotifyFromISR(task, wake, eSetBits, &woken);
+    return woken == pdTRUE;
+}
+
+void TimerScheduler::taskEntry(void* arg) {
+    static_cast<TimerScheduler*>(arg)->run();
+}
+
+void TimerScheduler::run() {
+    for (;;) {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+
+        for (uint8_t id = 0; id < TS_MAX_TIMERS; id++) {
+            if (!(bits & (1UL << id))) continue;
+            Slot& s = slots[id];
+
+            // Cancelled (and maybe reused) since the ISR queued it: pending
+            // is 0. Taken before the call, so a run due meanwhile is kept.
+            portENTER_CRITICAL(&lock);
+            bool go = s.inUse && s.pending;
+            s.pending = 0;
+            TimerCallback cb = s.cb;
+            void* arg = s.arg;
+            uint32_t jitter = (uint32_t)(counter() - s.due);
+            portEXIT_CRITICAL(&lock);
+            if (!go) continue;
+
+            uint32_t t0 = ESP.getCycleCount();
+            cb(arg);
+            uint32_t cycles = ESP.getCycleCount() - t0;
+
+            portENTER_CRITICAL(&lock);
+            if (s.inUse && s.cb == cb) {
+                s.runs++;
+                s.jitterSumUs += jitter;
+                if (jitter > s.jitterMaxUs) s.jitterMaxUs = jitter;
+                s.runSumCycles += cycles;
+                if (cycles > s.runMaxCycles) s.runMaxCycles = cycles;
+                if (!s.periodUs) s.inUse = false;
+            }
+            portEXIT_CRITICAL(&lock);
+        }
+    }
+}
+
+/************ MIN-HEAP (called with the lock held) ************/
+void IRAM_ATTR TimerScheduler::heapSwap(uint8_t a, uint8_t b) {
+    uint8_t t = heap[a];
+    heap[a] = heap[b];
+    heap[b] = t;
+    slots[heap[a]].heapPos = a;
+    slots[heap[b]].heapPos = b;
+}
+
+void IRAM_ATTR TimerScheduler::heapSiftUp(uint8_t pos) {
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (slots[heap[parent]].deadline <= slots[heap[pos]].deadline) break;
+        heapSwap(pos, parent);
+        pos = parent;
+    }
+}
+
+void IRAM_ATTR TimerScheduler::heapSiftDown(uint8_t pos) {
+    for (;;) {
+        uint8_t left = 2 * pos + 1;
+        uint8_t right = left + 1;
+        uint8_t least = pos;
+        if (left < heapSize && slots[heap[left]].deadline < slots[heap[least]].deadline) least = left;
+        if (right < heapSize && slots[heap[right]].deadline < slots[heap[least]].deadline) least = right;
+        if (least == pos) break;
+        heapSwap(pos, least);
+        pos = least;
+    }
+}
+
+void IRAM_ATTR TimerScheduler::heapPush(uint8_t id) {
+    uint8_t pos = heapSize++;
+    heap[pos] = id;
+    slots[id].heapPos = pos;
+    heapSiftUp(pos);
+}
+
+void IRAM_ATTR TimerScheduler::heapRemove(uint8_t pos) {
+    uint8_t id = heap[pos];
+    uint8_t last = --heapSize;
+    if (pos != last) {
+        heapSwap(pos, last);
+        heapSiftDown(pos);
+        heapSiftUp(pos);
+    }
+    slots[id].heapPos = -1;
+}
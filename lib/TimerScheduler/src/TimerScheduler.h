@@ -0,0 +1,136 @@
+// Many periodic and one-shot callbacks on one hardware timer
+// The timer counts microseconds and is never reloaded; every registered
+// callback has a 64-bit deadline on that count, kept in a binary min-heap.
+// The alarm is always programmed to the earliest deadline. When it fires,
+// the ISR runs everything that is due, moves periodic deadlines on by
+// whole periods (no drift) and re-arms the alarm for the new earliest one.
+//
+// A callback runs either in the ISR (TIMER_IN_ISR: microsecond-exact, but
+// it must be IRAM_ATTR, short, and may only touch registers or IRAM/DRAM
+// data - see gpioFastWrite() below) or in the scheduler's task
+// (TIMER_IN_TASK: any code, a task switch later). The ISR is installed
+// with ESP_INTR_FLAG_IRAM, so it keeps running while the flash cache is
+// off; its code and the heap operations live in IRAM, the heap in DRAM.
+//
+// Per callback the scheduler measures the jitter (how late it started
+// relative to its deadline) and the run time; see stats().
+
+#pragma once
+
+#include <Arduino.h>
+#include <driver/timer.h>
+#include <soc/gpio_struct.h>
+
+#define TS_MAX_TIMERS      16     // one task-notification bit each
+#define TS_MIN_LEAD_US     20     // deadlines closer than this are spun for
+#define TS_MIN_PERIOD_US   50
+#define TS_TASK_STACK      3072
+#define TS_TASK_PRIORITY   10
+
+typedef void (*TimerCallback)(void* arg);
+
+enum TimerDispatch : uint8_t {
+    TIMER_IN_ISR = 0,
+    TIMER_IN_TASK
+};
+
+struct TimerStats {
+    uint32_t runs;
+    uint32_t missed;        // periods skipped (overrun) or task runs coalesced
+    uint32_t jitterMaxUs;   // start after the deadline, worst
+    uint32_t jitterAvgUs;
+    uint32_t runMaxNs;      // time spent in the callback
+    uint32_t runAvgNs;
+};
+
+// Direct GPIO register access for TIMER_IN_ISR callbacks: digitalWrite()
+// and digitalRead() live in flash
+static inline void IRAM_ATTR gpioFastWrite(uint8_t pin, bool high) {
+    if (pin < 32) {
+        if (high) GPIO.out_w1ts = 1UL << pin;
+        else      GPIO.out_w1tc = 1UL << pin;
+    } else {
+        if (high) GPIO.out1_w1ts.val = 1UL << (pin - 32);
+        else      GPIO.out1_w1tc.val = 1UL << (pin - 32);
+    }
+}
+
+static inline bool IRAM_ATTR gpioFastOutput(uint8_t pin) {   // level being driven
+    return pin < 32 ? (GPIO.out >> pin) & 1 : (GPIO.out1.val >> (pin - 32)) & 1;
+}
+
+static inline void IRAM_ATTR gpioFastToggle(uint8_t pin) {
+    gpioFastWrite(pin, !gpioFastOutput(pin));
+}
+
+class TimerScheduler {
+public:
+    TimerScheduler(timer_group_t group = TIMER_GROUP_0, timer_idx_t index = TIMER_0);
+
+    // Starts the hardware timer (1 us ticks) and the dispatch task
+    bool begin();
+
+    // Registers a callback every periodUs (at least TS_MIN_PERIOD_US),
+    // first one a period from now. Returns its id, or -1 if all
+    // TS_MAX_TIMERS slots are in use.
+    int8_t every(uint32_t periodUs, TimerCallback cb, void* arg = nullptr,
+                 TimerDispatch dispatch = TIMER_IN_TASK);
+
+    // Registers a callback once, delayUs from now; its slot is freed after
+    // it ran
+    int8_t after(uint32_t delayUs, TimerCallback cb, void* arg = nullptr,
+                 TimerDispatch dispatch = TIMER_IN_TASK);
+
+    // Not from a TIMER_IN_ISR callback
+    bool cancel(int8_t id);
+
+    TimerStats stats(int8_t id) const;
+    uint32_t isrCount() const { return numIsr; }
+    uint32_t isrMaxNs() const;   // whole alarm handler, worst
+    uint64_t nowUs() const;
+
+private:
+    struct Slot {
+        TimerCallback cb;
+        void* arg;
+        uint32_t periodUs;     // 0 = one-shot
+        uint64_t deadline;
+        uint64_t due;          // deadline of the run handed to the task
+        TimerDispatch dispatch;
+        bool inUse;
+        int8_t heapPos;        // -1 when not scheduled
+        uint8_t pending;       // runs handed to the task, not yet done
+
+        uint32_t runs;
+        uint32_t missed;
+        uint32_t jitterMaxUs;
+        uint64_t jitterSumUs;
+        uint32_t runMaxCycles;
+        uint64_t runSumCycles;
+    };
+
+    int8_t add(uint32_t delayUs, uint32_t periodUs, TimerCallback cb, void* arg, TimerDispatch dispatch);
+    static bool IRAM_ATTR onAlarm(void* arg);
+    bool IRAM_ATTR dispatchDue();
+    void IRAM_ATTR heapPush(uint8_t id);
+    void IRAM_ATTR heapRemove(uint8_t pos);
+    void IRAM_ATTR heapSiftUp(uint8_t pos);
+    void IRAM_ATTR heapSiftDown(uint8_t pos);
+    void IRAM_ATTR heapSwap(uint8_t a, uint8_t b);
+    void IRAM_ATTR armFor(uint64_t deadline, uint64_t now);
+    uint64_t IRAM_ATTR counter() const;
+    static void taskEntry(void* arg);
+    void run();
+
+    timer_group_t group;
+    timer_idx_t index;
+    TaskHandle_t task;
+    mutable portMUX_TYPE lock;
+
+    Slot slots[TS_MAX_TIMERS];
+    uint8_t heap[TS_MAX_TIMERS];   // slot ids, earliest deadline first
+    uint8_t heapSize;
+
+    volatile uint32_t numIsr;
+    volatile uint32_t isrMaxCycles;
+};
@@ -0,0 +1,137 @@
+#include "ToneSequencer.h"
+
+ToneSequencer::ToneSequencer(uint8_t channel)
+    : channel(channel), timer(nullptr), lock(portMUX_INITIALIZER_UNLOCKED),
+      head(0), queued(0), index(0), inGap(false), playing(false), cut(false),
+      freqOut(0), dueUs(0), numNotes(0), numRejected(0), worstLateUs(0) {
+    current = { nullptr, 0, { 0, 0, 0 } };
+}
+
+bool ToneSequencer::begin() {
+    esp_timer_create_args_t args = {};
+    args.callback = onAlarm;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "tone";
+    return esp_timer_create(&args, &timer) == ESP_OK;
+}
+
+bool ToneSequencer::play(const Note* notes, uint8_t count, bool interrupt) {
+    if (!notes || !count) return false;
+    Sequence s = { notes, count, { 0, 0, 0 } };
+    return enqueue(s, interrupt);
+}
+
+bool ToneSequencer::tone(uint16_t freq, uint16_t ms, bool interrupt) {
+    Sequence s = { nullptr, 1, { freq, ms, 0 } };
+    return enqueue(s, interrupt);
+}
+
+void ToneSequencer::stop() {
+    portENTER_CRITICAL(&lock);
+    queued = 0;
+    cut = playing;
+    dueUs = 0;
+    bool wake = playing;
+    portEXIT_CRITICAL(&lock);
+    if (wake) kick();
+}
+
+bool ToneSequencer::busy() const {
+    portENTER_CRITICAL(&lock);
+    bool b = playing || queued;
+    portEXIT_CRITICAL(&lock);
+    return b;
+}
+
+bool ToneSequencer::enqueue(const Sequence& s, bool interrupt) {
+    if (!timer) return false;
+
+    portENTER_CRITICAL(&lock);
+    if (interrupt) {
+        queued = 0;
+        cut = playing;
+    }
+    if (queued == TONE_QUEUE_LEN) {
+        portEXIT_CRITICAL(&lock);
+        numRejected++;
+        return false;
+    }
+    queue[(head + queued) % TONE_QUEUE_LEN] = s;
+    queued++;
+    // Idle: nothing is armed, start now. Interrupting: fire early.
+    bool wake = !playing || interrupt;
+    if (wake) dueUs = 0;
+    playing = true;
+    portEXIT_CRITICAL(&lock);
+
+    if (wake) kick();
+    return true;
+}
+
+// Fires the alarm now. If step() is running at the same time and re-arms
+// the timer first, the start fails; stopping and retrying wins either way.
+void ToneSequencer::kick() {
+    esp_timer_stop(timer);
+    while (esp_timer_start_once(timer, 0) == ESP_ERR_INVALID_STATE) {
+        esp_timer_stop(timer);
+    }
+}
+
+void ToneSequencer::onAlarm(void* arg) {
+    static_cast<ToneSequencer*>(arg)->step();
+}
+
+// Runs in the esp_timer task at each note boundary: moves on to the gap
+// after the note, the next note or the next queued sequence
+void ToneSequencer::step() {
+    int64_t now = esp_timer_get_time();
+    uint16_t freq = 0;
+    uint32_t ms = 0;
+
+    portENTER_CRITICAL(&lock);
+    if (dueUs && now > dueUs) {
+        uint32_t late = (uint32_t)(now - dueUs);
+        if (late > worstLateUs) worstLateUs = late;
+    }
+
+    if (cut) {
+        cut = false;
+        current.count = 0;   // finished; fall through to the queue
+    }
+
+    const Note* notes = current.notes ? current.notes : &current.single;
+    if (!inGap && index < current.count && notes[index].gapMs) {
+        inGap = true;
+        ms = notes[index].gapMs;
+    } else {
+        inGap = false;
+        if (++index >= current.count) {
+            index = 0;
+            if (queued) {
+                current = queue[head];
+                head = (head + 1) % TONE_QUEUE_LEN;
+                queued--;
+            } else {
+                current.count = 0;
+                playing = false;
+            }
+        }
+        if (playing) {
+            notes = current.notes ? current.notes : &current.single;
+            freq = notes[index].freq;
+            ms = notes[index].ms;
+            numNotes++;
+        }
+    }
+    bool more = playing;
+    dueUs = more ? now + ms * 1000LL : 0;
+    portEXIT_CRITICAL(&lock);
+
+    // Re-programming the LEDC timer for an unchanged pitch would click
+    if (freq != freqOut) {
+        ledcWriteTone(channel, freq);
+        freqOut = freq;
+    }
+    if (more) esp_timer_start_once(timer, ms * 1000ULL);
+}
@@ -0,0 +1,79 @@
+// Non-blocking buzzer sequencer on an LEDC channel
+// A sequence is a table of notes (frequency, duration, gap after it).
+// Every note boundary is a one-shot esp_timer alarm, counted by the
+// hardware system timer; its callback switches the LEDC tone and arms the
+// next alarm. Playing sound therefore costs loop() nothing, and a loop()
+// that is slow or blocked does not stretch the notes.
+//
+// play() queues a sequence behind the one playing, or with interrupt = true
+// cuts it off and starts at once (e.g. an alert over background music).
+// The note tables are not copied: they must outlive their playback, which
+// is what const globals do.
+
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#define TONE_QUEUE_LEN  4    // sequences waiting behind the current one
+
+struct Note {
+    uint16_t freq;    // Hz, 0 = rest
+    uint16_t ms;      // how long it sounds
+    uint16_t gapMs;   // silence after it (staccato), 0 = legato
+};
+
+class ToneSequencer {
+public:
+    // The channel must already be set up and attached (ledcSetup/ledcAttachPin)
+    explicit ToneSequencer(uint8_t channel);
+
+    bool begin();
+
+    // Plays count notes; false if the queue is full (nothing changes then)
+    bool play(const Note* notes, uint8_t count, bool interrupt = false);
+
+    // A single note, e.g. a confirmation beep
+    bool tone(uint16_t freq, uint16_t ms, bool interrupt = false);
+
+    // Silences the buzzer and drops everything queued
+    void stop();
+
+    bool busy() const;
+    uint32_t notesPlayed() const { return numNotes; }
+    uint32_t rejected() const { return numRejected; }   // play() on a full queue
+    uint32_t maxLateUs() const { return worstLateUs; }  // alarm latency, worst seen
+
+private:
+    struct Sequence {
+        const Note* notes;   // nullptr: the single note below
+        uint8_t count;
+        Note single;
+    };
+
+    static void onAlarm(void* arg);
+    void step();
+    void kick();
+    bool enqueue(const Sequence& s, bool interrupt);
+
+    uint8_t channel;
+    esp_timer_handle_t timer;
+    mutable portMUX_TYPE lock;
+
+    Sequence queue[TONE_QUEUE_LEN];
+    uint8_t head;
+    uint8_t queued;
+
+    Sequence current;
+    uint8_t index;     // note of current
+    bool inGap;
+    bool playing;
+    bool cut;          // interrupt requested: drop current at the next alarm
+
+    uint16_t freqOut;  // frequency on the channel now
+    int64_t dueUs;     // when the armed alarm should fire
+
+    volatile uint32_t numNotes;
+    volatile uint32_t numRejected;
+    volatile uint32_t worstLateUs;
+};